@@ -0,0 +1,97 @@
+#include "gb_address.h"
+
+// ---- MCP23S17 (MCP1) ----
+
+static bool gb_address_mcp_init(GBAddressBackend* backend) {
+    MCP23S17* mcp = backend->device;
+    return mcp23s17_port_mode(mcp, MCP23S17_PORT_A, MCP23S17_PIN_MODE_OUTPUT) &&
+           mcp23s17_port_mode(mcp, MCP23S17_PORT_B, MCP23S17_PIN_MODE_OUTPUT);
+}
+
+// Una trama para los dos puertos, o sólo OLATA si A8-A15 no cambian
+static bool gb_address_mcp_write(GBAddressBackend* backend, uint16_t address) {
+    MCP23S17* mcp = backend->device;
+    uint8_t addr_low = address & 0xFF;
+    uint8_t addr_high = (address >> 8) & 0xFF;
+    
+    if(backend->valid && (backend->last_address >> 8) == addr_high) {
+        return mcp23s17_write_reg(mcp, MCP23S17_OLATA, addr_low);
+    }
+    return mcp23s17_write_ports(mcp, addr_low, addr_high);
+}
+
+static bool gb_address_mcp_is_connected(GBAddressBackend* backend) {
+    return mcp23s17_is_connected(backend->device);
+}
+
+// ---- 74HC595 ----
+
+static bool gb_address_595_init(GBAddressBackend* backend) {
+    Shift595* chain = backend->device;
+    return chain->initialized && chain->length == 2;
+}
+
+// A8-A15 van primero para que acaben en el segundo 595 de la cadena
+static bool gb_address_595_write(GBAddressBackend* backend, uint16_t address) {
+    uint8_t data[2] = {(address >> 8) & 0xFF, address & 0xFF};
+    return shift_595_write(backend->device, data);
+}
+
+// Los 595 no se pueden leer: sólo se comprueba que el driver está listo
+static bool gb_address_595_is_connected(GBAddressBackend* backend) {
+    Shift595* chain = backend->device;
+    return chain->initialized;
+}
+
+// ---- Interfaz común ----
+
+void gb_address_setup_mcp23s17(GBAddressBackend* backend, MCP23S17* mcp) {
+    backend->type = GB_ADDRESS_MCP23S17;
+    backend->init = gb_address_mcp_init;
+    backend->write = gb_address_mcp_write;
+    backend->is_connected = gb_address_mcp_is_connected;
+    backend->device = mcp;
+    backend->valid = false;
+}
+
+void gb_address_setup_shift_595(GBAddressBackend* backend, Shift595* chain) {
+    backend->type = GB_ADDRESS_SHIFT_595;
+    backend->init = gb_address_595_init;
+    backend->write = gb_address_595_write;
+    backend->is_connected = gb_address_595_is_connected;
+    backend->device = chain;
+    backend->valid = false;
+}
+
+bool gb_address_init(GBAddressBackend* backend) {
+    if(!backend || !backend->device) return false;
+    backend->valid = false;
+    return backend->init(backend);
+}
+
+// Pone la dirección en el bus si ha cambiado
+bool gb_address_set(GBAddressBackend* backend, uint16_t address) {
+    if(backend->valid && backend->last_address == address) return true;
+    
+    bool result = backend->write(backend, address);
+    backend->last_address = address;
+    backend->valid = result;
+    return result;
+}
+
+// Olvida la dirección en cache (por ejemplo si otro código ha tocado el bus)
+void gb_address_invalidate(GBAddressBackend* backend) {
+    if(backend) backend->valid = false;
+}
+
+bool gb_address_is_connected(GBAddressBackend* backend) {
+    return backend && backend->device && backend->is_connected(backend);
+}
+
+const char* gb_address_get_name(GBAddressType type) {
+    switch(type) {
+        case GB_ADDRESS_MCP23S17: return "MCP";
+        case GB_ADDRESS_SHIFT_595: return "595";
+        default: return "?";
+    }
+}
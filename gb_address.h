@@ -0,0 +1,44 @@
+#ifndef GB_ADDRESS_H
+#define GB_ADDRESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mcp23s17_api.h"
+#include "shift_595.h"
+
+// Hardware que pone A0-A15 en el bus del cartucho
+typedef enum {
+    GB_ADDRESS_MCP23S17 = 0,  // MCP1: A0-A7 en GPA, A8-A15 en GPB
+    GB_ADDRESS_SHIFT_595,     // Dos 74HC595: latch en PA4 (en lugar del CS del MCP1)
+    GB_ADDRESS_TYPE_COUNT
+} GBAddressType;
+
+// Backend por defecto; se puede cambiar al compilar (cdefines en application.fam)
+#ifndef GB_ADDRESS_DEFAULT_TYPE
+#define GB_ADDRESS_DEFAULT_TYPE GB_ADDRESS_MCP23S17
+#endif
+
+typedef struct GBAddressBackend GBAddressBackend;
+
+// Interfaz de un backend de direcciones. La cache de la última dirección es
+// común: 'write' sólo se llama cuando la dirección cambia
+struct GBAddressBackend {
+    GBAddressType type;
+    bool (*init)(GBAddressBackend* backend);
+    bool (*write)(GBAddressBackend* backend, uint16_t address);
+    bool (*is_connected)(GBAddressBackend* backend);
+    void* device;            // MCP23S17* o Shift595*
+    uint16_t last_address;   // Última dirección en el bus
+    bool valid;              // last_address es conocida
+};
+
+// Funciones de los backends
+void gb_address_setup_mcp23s17(GBAddressBackend* backend, MCP23S17* mcp);
+void gb_address_setup_shift_595(GBAddressBackend* backend, Shift595* chain);
+bool gb_address_init(GBAddressBackend* backend);
+bool gb_address_set(GBAddressBackend* backend, uint16_t address);
+void gb_address_invalidate(GBAddressBackend* backend);
+bool gb_address_is_connected(GBAddressBackend* backend);
+const char* gb_address_get_name(GBAddressType type);
+
+#endif // GB_ADDRESS_H
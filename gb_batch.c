@@ -0,0 +1,298 @@
+#include "gb_batch.h"
+#include <storage/storage.h>
+#include <string.h>
+
+// Verificación pendiente del último volcado (se hace mientras se cambia de cartucho)
+typedef struct {
+    bool pending;
+    char path[96];
+    uint32_t offset;
+    uint32_t size;
+    uint16_t expected;  // Checksum global del header
+    uint16_t sum;
+} GBBatchVerify;
+
+// Entrada del registro de la sesión, se escribe al terminar la verificación
+typedef struct {
+    char name[32];
+    uint32_t rom_size;
+    uint32_t save_size;
+    uint32_t elapsed_ms;
+    bool dump_ok;
+    bool size_mismatch;
+    bool removed;       // Se retiró el cartucho a mitad del volcado
+} GBBatchEntry;
+
+struct GBBatch {
+    FuriThread* thread;
+    FuriMutex* mutex;
+    volatile bool running;
+    GBDumpFormat format;
+    GBCartInfo info;
+    GBMapper mapper;
+    GBBatchVerify verify;
+    GBBatchEntry entry;
+    GBBatchStatus status;
+};
+
+static void gb_batch_set_state(GBBatch* batch, GBBatchState state) {
+    furi_mutex_acquire(batch->mutex, FuriWaitForever);
+    batch->status.state = state;
+    furi_mutex_release(batch->mutex);
+}
+
+// Devuelve false cuando se ha pedido parar: el volcado en curso se cancela
+// en el siguiente bloque en vez de terminar el cartucho
+static bool gb_batch_progress_callback(uint32_t done, uint32_t total, bool paused, void* context) {
+    GBBatch* batch = context;
+    furi_mutex_acquire(batch->mutex, FuriWaitForever);
+    batch->status.done = done;
+    batch->status.total = total;
+    batch->status.paused = paused;
+    furi_mutex_release(batch->mutex);
+    return batch->running;
+}
+
+// Añade una línea al CSV de la sesión
+static void gb_batch_log(GBBatch* batch, const char* verify_result) {
+    GBBatchEntry* entry = &batch->entry;
+    uint32_t speed = entry->elapsed_ms ? (uint64_t)entry->rom_size * 1000 / entry->elapsed_ms : 0;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool is_new = !storage_file_exists(storage, GB_BATCH_LOG_PATH);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, GB_BATCH_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        char line[128];
+        if(is_new) {
+            const char* header = "name,rom_bytes,save_bytes,ms,bytes_per_s,dump,size,file_checksum\n";
+            storage_file_write(file, header, strlen(header));
+        }
+        int length = snprintf(
+            line,
+            sizeof(line),
+            "%s,%lu,%lu,%lu,%lu,%s,%s,%s\n",
+            entry->name,
+            entry->rom_size,
+            entry->save_size,
+            entry->elapsed_ms,
+            speed,
+            entry->dump_ok ? "OK" : "ERROR",
+            entry->size_mismatch ? "MISMATCH" : "OK",
+            verify_result);
+        storage_file_write(file, line, length);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Termina una entrada: actualiza contadores y la escribe al registro
+static void gb_batch_finish_entry(GBBatch* batch, const char* verify_result, bool ok) {
+    gb_batch_log(batch, verify_result);
+
+    furi_mutex_acquire(batch->mutex, FuriWaitForever);
+    if(ok) {
+        batch->status.carts_ok++;
+    } else {
+        batch->status.carts_failed++;
+    }
+    snprintf(batch->status.last_result, sizeof(batch->status.last_result), "%s: %s",
+             batch->entry.name, verify_result);
+    furi_mutex_release(batch->mutex);
+}
+
+// Verifica un trozo del último archivo volcado recalculando el checksum global.
+// Sólo comprueba que el archivo RAW cuadra con el header; no relee el
+// cartucho, que ya se está cambiando. Devuelve true mientras queda trabajo
+// pendiente
+static bool gb_batch_verify_step(GBBatch* batch) {
+    GBBatchVerify* verify = &batch->verify;
+    if(!verify->pending) return false;
+
+    uint8_t* buffer = malloc(GB_DUMP_CHUNK_SIZE);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool io_ok = storage_file_open(file, verify->path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                 storage_file_seek(file, verify->offset, true);
+
+    uint32_t end = verify->offset + GB_BATCH_VERIFY_CHUNK;
+    if(end > verify->size) end = verify->size;
+    while(io_ok && verify->offset < end) {
+        size_t chunk = (end - verify->offset < GB_DUMP_CHUNK_SIZE) ? end - verify->offset : GB_DUMP_CHUNK_SIZE;
+        if(storage_file_read(file, buffer, chunk) != chunk) {
+            io_ok = false;
+            break;
+        }
+        for(size_t i = 0; i < chunk; i++) {
+            uint32_t address = verify->offset + i;
+            // Los dos bytes del checksum no se suman
+            if(address != GB_CART_GLOBAL_CHECKSUM && address != GB_CART_GLOBAL_CHECKSUM + 1) {
+                verify->sum += buffer[i];
+            }
+        }
+        verify->offset += chunk;
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    free(buffer);
+
+    if(!io_ok) {
+        verify->pending = false;
+        gb_batch_finish_entry(batch, "READ_ERROR", false);
+    } else if(verify->offset >= verify->size) {
+        verify->pending = false;
+        bool match = (verify->sum == verify->expected);
+        gb_batch_finish_entry(batch, match ? "SUM_OK" : "SUM_BAD", match);
+    }
+    return verify->pending;
+}
+
+// Espera a que el logo se lea bien dos veces seguidas (cartucho bien asentado)
+static bool gb_batch_cart_present(void) {
+    if(!gb_cart_check_logo(GB_BATCH_LOGO_PROBE)) return false;
+    furi_delay_ms(GB_BATCH_POLL_MS);
+    return gb_cart_check_logo(GB_CART_LOGO_SIZE);
+}
+
+// Vuelca ROM y save del cartucho insertado con nombre automático
+static void gb_batch_dump_cart(GBBatch* batch) {
+    GBBatchEntry* entry = &batch->entry;
+    memset(entry, 0, sizeof(GBBatchEntry));
+
+    if(!gb_cart_read_info(&batch->info) || !gb_mapper_init(&batch->mapper, &batch->info)) {
+        snprintf(entry->name, sizeof(entry->name), "UNKNOWN");
+        gb_batch_finish_entry(batch, "HEADER", false);
+        return;
+    }
+
+    snprintf(entry->name, sizeof(entry->name), "%s_%04X",
+             batch->info.title[0] ? batch->info.title : "ROM", batch->info.global_checksum);
+    furi_mutex_acquire(batch->mutex, FuriWaitForever);
+    strncpy(batch->status.title, batch->info.title, sizeof(batch->status.title));
+    batch->status.state = GB_BATCH_DUMPING;
+    batch->status.done = 0;
+    batch->status.total = batch->info.rom_size;
+    furi_mutex_release(batch->mutex);
+
+    const char* ext = (batch->format == GB_DUMP_FORMAT_GBZ) ? GB_DUMP_COMPRESSED_EXT : "";
+    char rom_path[96];
+    char save_path[96];
+    snprintf(rom_path, sizeof(rom_path), "%s/%s.gb%s", GB_BATCH_FOLDER, entry->name, ext);
+    snprintf(save_path, sizeof(save_path), "%s/%s.sav%s", GB_BATCH_FOLDER, entry->name, ext);
+
+    uint32_t start = furi_get_tick();
+    GBDumpResult result;
+    entry->dump_ok = gb_dump_rom(&batch->mapper, &batch->info, rom_path, batch->format,
+                                 gb_batch_progress_callback, batch, &result);
+    entry->rom_size = result.bytes_read;
+    entry->size_mismatch = result.size_mismatch;
+    entry->removed = (result.error == GB_DUMP_ERROR_CART_REMOVED);
+    bool aborted = (result.error == GB_DUMP_ERROR_ABORTED);
+
+    if(entry->dump_ok && batch->mapper.ram_size > 0) {
+        GBDumpResult save_result;
+        entry->dump_ok = gb_dump_save(&batch->mapper, save_path, batch->format,
+                                      gb_batch_progress_callback, batch, &save_result);
+        entry->save_size = save_result.bytes_read;
+        aborted = (save_result.error == GB_DUMP_ERROR_ABORTED);
+    }
+    entry->elapsed_ms = (furi_get_tick() - start) * 1000 / furi_kernel_get_tick_frequency();
+
+    if(!entry->dump_ok) {
+        gb_batch_finish_entry(
+            batch, aborted ? "ABORTED" : (entry->removed ? "REMOVED" : "DUMP_ERROR"), false);
+    } else if(batch->format == GB_DUMP_FORMAT_RAW) {
+        // La verificación del archivo se hará mientras se cambia de cartucho
+        GBBatchVerify* verify = &batch->verify;
+        memset(verify, 0, sizeof(GBBatchVerify));
+        verify->pending = true;
+        verify->size = result.bytes_read;
+        verify->expected = batch->info.global_checksum;
+        strncpy(verify->path, rom_path, sizeof(verify->path) - 1);
+    } else {
+        // El checksum no se puede recalcular sin descomprimir
+        gb_batch_finish_entry(batch, "UNVERIFIED", true);
+    }
+}
+
+static int32_t gb_batch_worker(void* context) {
+    GBBatch* batch = context;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, APP_DATA_PATH(""));
+    storage_simply_mkdir(storage, GB_BATCH_FOLDER);
+    furi_record_close(RECORD_STORAGE);
+
+    bool cart_inserted = false;
+    while(batch->running) {
+        if(!cart_inserted) {
+            gb_batch_set_state(batch, GB_BATCH_WAITING_CART);
+            // Terminar de verificar el anterior antes de empezar otro volcado
+            if(!gb_batch_verify_step(batch) && gb_batch_cart_present()) {
+                cart_inserted = true;
+                gb_batch_dump_cart(batch);
+                gb_batch_set_state(batch, GB_BATCH_WAITING_REMOVAL);
+            }
+        } else {
+            // Verificar el anterior mientras el operador cambia el cartucho
+            gb_batch_verify_step(batch);
+            if(!gb_cart_check_logo(GB_BATCH_LOGO_PROBE)) {
+                cart_inserted = false;
+            }
+        }
+
+        // Con verificación pendiente cada paso ya marca el ritmo del sondeo
+        if(!batch->verify.pending) {
+            furi_delay_ms(GB_BATCH_POLL_MS);
+        }
+    }
+
+    // Completar la verificación pendiente para que quede en el registro
+    while(gb_batch_verify_step(batch)) {
+    }
+
+    gb_batch_set_state(batch, GB_BATCH_STOPPED);
+    return 0;
+}
+
+GBBatch* gb_batch_alloc(GBDumpFormat format) {
+    GBBatch* batch = malloc(sizeof(GBBatch));
+    memset(batch, 0, sizeof(GBBatch));
+    batch->format = format;
+    batch->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    batch->status.state = GB_BATCH_STOPPED;
+    batch->thread = furi_thread_alloc_ex("GBBatchWorker", 3 * 1024, gb_batch_worker, batch);
+    return batch;
+}
+
+// Espera al worker y libera el lote. Para no bloquear la interfaz se llama
+// después de gb_batch_stop, cuando el estado ya es GB_BATCH_STOPPED
+void gb_batch_free(GBBatch* batch) {
+    if(!batch) return;
+    gb_batch_stop(batch);
+    furi_thread_join(batch->thread);
+    furi_thread_free(batch->thread);
+    furi_mutex_free(batch->mutex);
+    free(batch);
+}
+
+void gb_batch_start(GBBatch* batch) {
+    if(batch->running) return;
+    batch->running = true;
+    gb_batch_set_state(batch, GB_BATCH_WAITING_CART);
+    furi_thread_start(batch->thread);
+}
+
+// Pide al worker que pare sin esperarle: el volcado en curso se cancela en
+// el siguiente bloque y el estado pasa a GB_BATCH_STOPPED al salir
+void gb_batch_stop(GBBatch* batch) {
+    batch->running = false;
+}
+
+void gb_batch_get_status(GBBatch* batch, GBBatchStatus* status) {
+    furi_mutex_acquire(batch->mutex, FuriWaitForever);
+    *status = batch->status;
+    furi_mutex_release(batch->mutex);
+}
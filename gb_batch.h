@@ -0,0 +1,45 @@
+#ifndef GB_BATCH_H
+#define GB_BATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gb_dump.h"
+
+// Carpeta y registro de la sesión por lotes
+#define GB_BATCH_FOLDER   APP_DATA_PATH("batch")
+#define GB_BATCH_LOG_PATH APP_DATA_PATH("batch/session.csv")
+
+// Intervalo de sondeo del cartucho y bytes verificados entre sondeos
+#define GB_BATCH_POLL_MS      250
+#define GB_BATCH_VERIFY_CHUNK 4096
+#define GB_BATCH_LOGO_PROBE   8
+
+typedef enum {
+    GB_BATCH_WAITING_CART = 0,  // Esperando a que se inserte un cartucho
+    GB_BATCH_DUMPING,           // Volcando ROM y save
+    GB_BATCH_WAITING_REMOVAL,   // Verificando el anterior mientras se cambia
+    GB_BATCH_STOPPED
+} GBBatchState;
+
+// Estado visible desde la interfaz
+typedef struct {
+    GBBatchState state;
+    uint16_t carts_ok;
+    uint16_t carts_failed;
+    char title[17];
+    uint32_t done;
+    uint32_t total;
+    bool paused;        // Volcado en pausa esperando el cartucho
+    char last_result[32];
+} GBBatchStatus;
+
+typedef struct GBBatch GBBatch;
+
+// Funciones del modo por lotes
+GBBatch* gb_batch_alloc(GBDumpFormat format);
+void gb_batch_free(GBBatch* batch);
+void gb_batch_start(GBBatch* batch);
+void gb_batch_stop(GBBatch* batch);
+void gb_batch_get_status(GBBatch* batch, GBBatchStatus* status);
+
+#endif // GB_BATCH_H
@@ -0,0 +1,165 @@
+#include "gb_camera.h"
+#include <storage/storage.h>
+#include <string.h>
+
+// BMP de 4 bits por píxel con paleta de 4 grises, filas de arriba a abajo
+#define GB_CAMERA_BMP_ROW_SIZE      (GB_CAMERA_WIDTH / 2)
+#define GB_CAMERA_BMP_PALETTE_SIZE  (4 * 4)
+#define GB_CAMERA_BMP_HEADER_SIZE   (14 + 40 + GB_CAMERA_BMP_PALETTE_SIZE)
+#define GB_CAMERA_BMP_FILE_SIZE     (GB_CAMERA_BMP_HEADER_SIZE + GB_CAMERA_BMP_ROW_SIZE * GB_CAMERA_HEIGHT)
+
+// Expande un plano de bits de un tile (8 píxeles) a 4 bytes de nibbles:
+// el píxel de la izquierda (bit 7) va en el nibble alto del primer byte
+static uint32_t gb_camera_plane_lut[256];
+static bool gb_camera_lut_ready = false;
+
+static void gb_camera_init_lut(void) {
+    if(gb_camera_lut_ready) return;
+    for(uint16_t value = 0; value < 256; value++) {
+        uint32_t expanded = 0;
+        for(uint8_t pixel = 0; pixel < 8; pixel++) {
+            if(value & (0x80 >> pixel)) {
+                uint8_t shift = (pixel / 2) * 8 + ((pixel % 2) ? 0 : 4);
+                expanded |= 1UL << shift;
+            }
+        }
+        gb_camera_plane_lut[value] = expanded;
+    }
+    gb_camera_lut_ready = true;
+}
+
+static void gb_camera_put_le32(uint8_t* buffer, uint32_t value) {
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
+    buffer[2] = (value >> 16) & 0xFF;
+    buffer[3] = (value >> 24) & 0xFF;
+}
+
+static void gb_camera_build_bmp_header(uint8_t* header) {
+    memset(header, 0, GB_CAMERA_BMP_HEADER_SIZE);
+
+    // BITMAPFILEHEADER
+    header[0] = 'B';
+    header[1] = 'M';
+    gb_camera_put_le32(&header[2], GB_CAMERA_BMP_FILE_SIZE);
+    gb_camera_put_le32(&header[10], GB_CAMERA_BMP_HEADER_SIZE);
+
+    // BITMAPINFOHEADER (altura negativa = filas de arriba a abajo)
+    gb_camera_put_le32(&header[14], 40);
+    gb_camera_put_le32(&header[18], GB_CAMERA_WIDTH);
+    gb_camera_put_le32(&header[22], (uint32_t)(-GB_CAMERA_HEIGHT));
+    header[26] = 1;   // Planos
+    header[28] = 4;   // Bits por píxel
+    gb_camera_put_le32(&header[34], GB_CAMERA_BMP_ROW_SIZE * GB_CAMERA_HEIGHT);
+    gb_camera_put_le32(&header[46], 4);  // Colores usados
+
+    // Paleta BGRA: color 0 = blanco ... color 3 = negro
+    static const uint8_t shades[4] = {0xFF, 0xAA, 0x55, 0x00};
+    for(uint8_t i = 0; i < 4; i++) {
+        uint8_t* entry = &header[54 + i * 4];
+        entry[0] = shades[i];
+        entry[1] = shades[i];
+        entry[2] = shades[i];
+    }
+}
+
+// Decodifica una fila de 16 tiles (8 líneas de píxeles) al formato BMP
+static void gb_camera_decode_tile_row(const uint8_t* tiles, uint8_t* rows) {
+    for(uint8_t tile = 0; tile < GB_CAMERA_TILES_PER_ROW; tile++) {
+        const uint8_t* tile_data = &tiles[tile * GB_CAMERA_TILE_SIZE];
+        for(uint8_t line = 0; line < 8; line++) {
+            uint32_t pixels = gb_camera_plane_lut[tile_data[line * 2]] |
+                              (gb_camera_plane_lut[tile_data[line * 2 + 1]] << 1);
+            uint8_t* out = &rows[line * GB_CAMERA_BMP_ROW_SIZE + tile * 4];
+            gb_camera_put_le32(out, pixels);
+        }
+    }
+}
+
+// Comprueba si el cartucho es una Game Boy Camera con su SRAM completa
+bool gb_camera_is_camera(const GBMapper* mapper) {
+    return mapper && mapper->type == GB_MAPPER_POCKET_CAMERA &&
+           mapper->ram_size >= GB_CAMERA_PHOTO_BASE + GB_CAMERA_PHOTO_SLOTS * GB_CAMERA_PHOTO_STRIDE;
+}
+
+// Escribe una foto leyendo y decodificando una fila de tiles cada vez
+static bool gb_camera_save_photo(GBMapper* mapper, File* file, uint8_t slot, uint8_t* tiles, uint8_t* rows) {
+    uint8_t header[GB_CAMERA_BMP_HEADER_SIZE];
+    gb_camera_build_bmp_header(header);
+    if(storage_file_write(file, header, sizeof(header)) != sizeof(header)) return false;
+
+    uint32_t offset = GB_CAMERA_PHOTO_BASE + (uint32_t)slot * GB_CAMERA_PHOTO_STRIDE;
+    for(uint8_t tile_row = 0; tile_row < GB_CAMERA_TILE_ROWS; tile_row++) {
+        if(!gb_mapper_read_ram(mapper, offset, tiles, GB_CAMERA_TILE_ROW_SIZE)) return false;
+        gb_camera_decode_tile_row(tiles, rows);
+        if(storage_file_write(file, rows, GB_CAMERA_BMP_ROW_SIZE * 8) != GB_CAMERA_BMP_ROW_SIZE * 8) {
+            return false;
+        }
+        offset += GB_CAMERA_TILE_ROW_SIZE;
+    }
+    return true;
+}
+
+// Extrae las fotos válidas de la SRAM a archivos BMP en 'folder'.
+// Sólo se leen los slots marcados como usados en el vector de estado
+bool gb_camera_extract_photos(
+    GBMapper* mapper,
+    const char* folder,
+    GBDumpProgressCallback callback,
+    void* context,
+    uint8_t* photos_saved) {
+    if(!gb_camera_is_camera(mapper) || !folder || !photos_saved) return false;
+    *photos_saved = 0;
+
+    // Vector de estado + "Magic"
+    uint8_t state[GB_CAMERA_STATE_MAGIC + 5 - GB_CAMERA_STATE_VECTOR];
+    if(!gb_mapper_read_ram(mapper, GB_CAMERA_STATE_VECTOR, state, sizeof(state))) {
+        FURI_LOG_E("GB_CAMERA", "Error al leer el vector de estado");
+        return false;
+    }
+    if(memcmp(&state[GB_CAMERA_STATE_MAGIC - GB_CAMERA_STATE_VECTOR], "Magic", 5) != 0) {
+        FURI_LOG_W("GB_CAMERA", "Vector de estado sin firma, se usa igualmente");
+    }
+
+    uint8_t used = 0;
+    for(uint8_t slot = 0; slot < GB_CAMERA_PHOTO_SLOTS; slot++) {
+        if(state[slot] != GB_CAMERA_SLOT_FREE) used++;
+    }
+    FURI_LOG_I("GB_CAMERA", "Fotos en la cámara: %d", used);
+
+    gb_camera_init_lut();
+    uint8_t* tiles = malloc(GB_CAMERA_TILE_ROW_SIZE);
+    uint8_t* rows = malloc(GB_CAMERA_BMP_ROW_SIZE * 8);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, folder);
+    File* file = storage_file_alloc(storage);
+    bool success = true;
+
+    char path[96];
+    for(uint8_t slot = 0; slot < GB_CAMERA_PHOTO_SLOTS && success; slot++) {
+        if(state[slot] == GB_CAMERA_SLOT_FREE) continue;
+
+        snprintf(path, sizeof(path), "%s/foto_%02d.bmp", folder, slot + 1);
+        if(!storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            FURI_LOG_E("GB_CAMERA", "No se pudo crear %s", path);
+            success = false;
+            break;
+        }
+        success = gb_camera_save_photo(mapper, file, slot, tiles, rows);
+        storage_file_close(file);
+
+        if(success) {
+            (*photos_saved)++;
+            if(callback && !callback(*photos_saved, used, false, context)) break;
+        } else {
+            FURI_LOG_E("GB_CAMERA", "Error al guardar la foto %d", slot + 1);
+        }
+    }
+
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    free(tiles);
+    free(rows);
+    gb_mapper_disable_ram(mapper);
+    return success;
+}
@@ -0,0 +1,34 @@
+#ifndef GB_CAMERA_H
+#define GB_CAMERA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gb_mapper.h"
+#include "gb_dump.h"
+
+// Organización de la SRAM de la Game Boy Camera (128KB)
+#define GB_CAMERA_PHOTO_SLOTS       30
+#define GB_CAMERA_STATE_VECTOR      0x11B2   // Un byte por slot, 0xFF = libre
+#define GB_CAMERA_STATE_MAGIC       0x11D0   // "Magic" justo tras el vector (0x11B2-0x11CF)
+#define GB_CAMERA_PHOTO_BASE        0x2000   // Slot 0 empieza en el banco 1
+#define GB_CAMERA_PHOTO_STRIDE      0x1000
+#define GB_CAMERA_SLOT_FREE         0xFF
+
+// Imagen: 128x112 píxeles en tiles de 8x8 a 2bpp
+#define GB_CAMERA_WIDTH             128
+#define GB_CAMERA_HEIGHT            112
+#define GB_CAMERA_TILES_PER_ROW     (GB_CAMERA_WIDTH / 8)
+#define GB_CAMERA_TILE_ROWS         (GB_CAMERA_HEIGHT / 8)
+#define GB_CAMERA_TILE_SIZE         16
+#define GB_CAMERA_TILE_ROW_SIZE     (GB_CAMERA_TILES_PER_ROW * GB_CAMERA_TILE_SIZE)
+
+// Funciones de la cámara
+bool gb_camera_is_camera(const GBMapper* mapper);
+bool gb_camera_extract_photos(
+    GBMapper* mapper,
+    const char* folder,
+    GBDumpProgressCallback callback,
+    void* context,
+    uint8_t* photos_saved);
+
+#endif // GB_CAMERA_H
@@ -2,10 +2,6 @@
 #include "mcp23s17_api.h"
 #include <string.h>
 
-// Definiciones de pines para MCP1 (Control de direcciones)
-#define MCP1_ADDR_LOW_PORT    MCP23S17_PORT_A  // GPA0-GPA7: A0-A7
-#define MCP1_ADDR_HIGH_PORT   MCP23S17_PORT_B  // GPB0-GPB7: A8-A15
-
 // Definiciones de pines para MCP2 (Datos y control)
 #define GB_MCP2_DATA_PORT        MCP23S17_PORT_A  // GPA0-GPA7: D0-D7
 #define GB_MCP2_DATA_HIGH_PORT   MCP23S17_PORT_B  // GPB0-GPB7: D8-D15
@@ -53,83 +49,26 @@
 
 
 
-// # GBA
-//  ## Pines de control en MCP1
-//  (24 Bit Address Bus)
-// ## Pines de control en MCP1 (GPA0-GPA7)
-#define GBA_MCP1_A0_PIN          0  // GPA0: A0
-#define GBA_MCP1_A1_PIN          1  // GPA1: A1
-#define GBA_MCP1_A2_PIN          2  // GPA2: A2
-#define GBA_MCP1_A3_PIN          3  // GPA3: A3
-#define GBA_MCP1_A4_PIN          4  // GPA4: A4
-#define GBA_MCP1_A5_PIN          5  // GPA5: A5
-#define GBA_MCP1_A6_PIN          6  // GPA6: A6
-#define GBA_MCP1_A7_PIN          7  // GPA7: A7
-
-// ## Pines de control en MCP1 (GPB0-GPB7)
-#define GBA_MCP1_A8_PIN          0  // GPB0: A8
-#define GBA_MCP1_A9_PIN          1  // GPB1: A9
-#define GBA_MCP1_A10_PIN         2  // GPB2: A10
-#define GBA_MCP1_A11_PIN         3  // GPB3: A11
-#define GBA_MCP1_A12_PIN         4  // GPB4: A12
-#define GBA_MCP1_A13_PIN         5  // GPB5: A13
-#define GBA_MCP1_A14_PIN         6  // GPB6: A14
-#define GBA_MCP1_A15_PIN         7  // GPB7: A15
-
-// ## Pines de control en MCP2 (GPA0-GPA7)
-#define GBA_MCP2_CLK_PIN          0  // GPA0: CLK
-#define GBA_MCP2_WR_PIN           1  // GPA1: WR
-#define GBA_MCP2_RD_PIN           2  // GPA2: RD
-#define GBA_MCP2_CS_PIN           3  // GPA3: CS
-#define GBA_MCP2_CS2_PIN          4  // GPA4: CS2
-#define GBA_MCP2_IRQ_PIN          5  // GPA5: IRQ
-#define GBA_MCP2_VOLTAGE_PIN      6  // GPA6: VOLTAGE_SELECT
-#define GBA_MCP2_ACTIVITY_PIN     7  // GPA7: ACTIVITY_LED
 
-// ## Pines de datos en MCP2 (GPB0-GPB7)
-#define GBA_MCP2_A16_PIN          0  // GPB0: A16
-#define GBA_MCP2_A17_PIN          1  // GPB1: A17
-#define GBA_MCP2_A18_PIN          2  // GPB2: A18
-#define GBA_MCP2_A19_PIN          3  // GPB3: A19
-#define GBA_MCP2_A20_PIN          4  // GPB4: A20
-#define GBA_MCP2_A21_PIN          5  // GPB5: A21
-#define GBA_MCP2_A22_PIN          6  // GPB6: A22
-#define GBA_MCP2_A23_PIN          7  // GPB7: A23
+// Pines nativos del Flipper para las señales en el cableado híbrido
+#define GB_NATIVE_RD_PIN (&gpio_ext_pc0)
+#define GB_NATIVE_WR_PIN (&gpio_ext_pc1)
+#define GB_NATIVE_CS_PIN (&gpio_ext_pb2)
 
-//  (16 Bit Data Bus)
-// ## Pines de control en MCP1 (GPA0-GPA7)
-#define GBA_MCP1_D0_PIN          0  // GPA0: A0
-#define GBA_MCP1_D1_PIN          1  // GPA1: A1
-#define GBA_MCP1_D2_PIN          2  // GPA2: A2
-#define GBA_MCP1_D3_PIN          3  // GPA3: A3
-#define GBA_MCP1_D4_PIN          4  // GPA4: A4
-#define GBA_MCP1_D5_PIN          5  // GPA5: A5
-#define GBA_MCP1_D6_PIN          6  // GPA6: A6
-#define GBA_MCP1_D7_PIN          7  // GPA7: A7
-
-// ## Pines de control en MCP1 (GPB0-GPB7)
-#define GBA_MCP1_D8_PIN          0  // GPB0: A8
-#define GBA_MCP1_D9_PIN          1  // GPB1: A9
-#define GBA_MCP1_D10_PIN         2  // GPB2: A10
-#define GBA_MCP1_D11_PIN         3  // GPB3: A11
-#define GBA_MCP1_D12_PIN         4  // GPB4: A12
-#define GBA_MCP1_D13_PIN         5  // GPB5: A13
-#define GBA_MCP1_D14_PIN         6  // GPB6: A14
-#define GBA_MCP1_D15_PIN         7  // GPB7: A15
-
-
-// Variables globales para los MCP23S17
-static MCP23S17* mcp1 = NULL;
+// Backend de direcciones (MCP1 o 74HC595) y MCP23S17 de datos/control
+static GBAddressBackend* address_backend = NULL;
 static MCP23S17* mcp2 = NULL;
 
-// Función para inicializar los MCP23S17
-bool gb_cart_init(MCP23S17* mcp1_instance, MCP23S17* mcp2_instance) {
-    mcp1 = mcp1_instance;
+// Cableado activo y estado del CS nativo (sólo en híbrido)
+static GBCartWiring gb_cart_wiring = GB_CART_DEFAULT_WIRING;
+static bool gb_cart_native_cs = true;
+
+// Función para inicializar el lector: dirección y MCP23S17 de datos/control
+bool gb_cart_init(GBAddressBackend* address, MCP23S17* mcp2_instance) {
     mcp2 = mcp2_instance;
     
-    // Configurar MCP1 para control de direcciones
-    mcp23s17_port_mode(mcp1, MCP1_ADDR_LOW_PORT, MCP23S17_PIN_MODE_OUTPUT);
-    mcp23s17_port_mode(mcp1, MCP1_ADDR_HIGH_PORT, MCP23S17_PIN_MODE_OUTPUT);
+    // Configurar el backend de direcciones
+    gb_cart_set_address_backend(address);
     
     // Configurar MCP2 para datos y señales de control
     mcp23s17_port_mode(mcp2, GB_MCP2_DATA_PORT, MCP23S17_PIN_MODE_INPUT);
@@ -138,35 +77,178 @@ bool gb_cart_init(MCP23S17* mcp1_instance, MCP23S17* mcp2_instance) {
     // Configurar pines de control en MCP2
     mcp23s17_port_mode(mcp2, GB_MCP2_DATA_PORT, MCP23S17_PIN_MODE_OUTPUT);
     
-    // Inicializar señales de control en MCP2
+    // Inicializar señales de control en MCP2 (RD, WR y CS activos en bajo)
     mcp23s17_digital_write(mcp2, GB_MCP2_RD_PIN, GB_MCP2_DATA_PORT, 1);  // RD
-    mcp23s17_digital_write(mcp2, GB_MCP2_WR_PIN, GB_MCP2_DATA_PORT, 0);  // WR
+    mcp23s17_digital_write(mcp2, GB_MCP2_WR_PIN, GB_MCP2_DATA_PORT, 1);  // WR
     mcp23s17_digital_write(mcp2, GB_MCP2_CS_PIN, GB_MCP2_DATA_PORT, 0);  // CS
     mcp23s17_digital_write(mcp2, GB_MCP2_CLK_PIN, GB_MCP2_DATA_PORT, 1); // CLK
+    // Sacar el cartucho de reset para que el MBC acepte cambios de banco
+    mcp23s17_digital_write(mcp2, GB_MCP2_RST_PIN, GB_MCP2_DATA_PORT, 1); // RST
+    
+    // Slot a 5 V (puede venir del modo GBA, a 3,3 V)
+    if (!gb_cart_set_voltage(GB_CART_VOLTAGE_5V)) {
+        return false;
+    }
+    
+    return gb_cart_set_wiring(gb_cart_wiring);
+}
+
+// Función para cambiar el hardware de direcciones sin reiniciar el lector
+bool gb_cart_set_address_backend(GBAddressBackend* address) {
+    address_backend = address;
+    if (!gb_address_init(address_backend)) {
+        FURI_LOG_E("GB_CART", "No se pudo inicializar el backend de direcciones");
+        return false;
+    }
+    return true;
+}
+
+// Cambia el pin nativo de una señal y lo anota en la traza del bus
+static void gb_cart_native_write(const GpioPin* pin, uint8_t trace_pin, bool level) {
+    furi_hal_gpio_write(pin, level);
+    if (mcp23s17_trace_is_active()) {
+        uint8_t data = level;
+        mcp23s17_trace_record(mcp23s17_trace_timestamp(), MCP23S17_TRACE_CHIP_GPIO,
+                              0, trace_pin, &data, 1);
+    }
+}
+
+// Función para elegir el cableado de RD/WR/CS
+bool gb_cart_set_wiring(GBCartWiring wiring) {
+    if (wiring >= GB_CART_WIRING_COUNT) return false;
+    
+    if (wiring == GB_CART_WIRING_HYBRID) {
+        // Señales en reposo (activas en bajo) antes de activar las salidas
+        furi_hal_gpio_write(GB_NATIVE_RD_PIN, true);
+        furi_hal_gpio_write(GB_NATIVE_WR_PIN, true);
+        furi_hal_gpio_write(GB_NATIVE_CS_PIN, true);
+        furi_hal_gpio_init(GB_NATIVE_RD_PIN, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+        furi_hal_gpio_init(GB_NATIVE_WR_PIN, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+        furi_hal_gpio_init(GB_NATIVE_CS_PIN, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+        gb_cart_native_cs = true;
+    } else {
+        furi_hal_gpio_init_simple(GB_NATIVE_RD_PIN, GpioModeAnalog);
+        furi_hal_gpio_init_simple(GB_NATIVE_WR_PIN, GpioModeAnalog);
+        furi_hal_gpio_init_simple(GB_NATIVE_CS_PIN, GpioModeAnalog);
+    }
+    
+    gb_cart_wiring = wiring;
+    gb_address_invalidate(address_backend);
+    return true;
+}
+
+// Función para liberar el lector: en híbrido RD/WR/CS quedan como salidas
+// push-pull, se devuelven a analógico como hace mcp23s17_deinit con su CS
+void gb_cart_deinit(void) {
+    furi_hal_gpio_init_simple(GB_NATIVE_RD_PIN, GpioModeAnalog);
+    furi_hal_gpio_init_simple(GB_NATIVE_WR_PIN, GpioModeAnalog);
+    furi_hal_gpio_init_simple(GB_NATIVE_CS_PIN, GpioModeAnalog);
+    mcp2 = NULL;
+}
+
+GBCartWiring gb_cart_get_wiring(void) {
+    return gb_cart_wiring;
+}
+
+const char* gb_cart_get_wiring_name(GBCartWiring wiring) {
+    switch(wiring) {
+        case GB_CART_WIRING_MCP: return "MCP";
+        case GB_CART_WIRING_HYBRID: return "Hibrido";
+        default: return "?";
+    }
+}
+
+// Función para mover RD, WR o CS según el cableado activo (MCP2 o pin nativo)
+void gb_cart_set_signal(GBCartSignal signal, bool level) {
+    if (gb_cart_wiring == GB_CART_WIRING_HYBRID) {
+        switch(signal) {
+            case GB_CART_SIGNAL_RD:
+                gb_cart_native_write(GB_NATIVE_RD_PIN, GB_CART_TRACE_PIN_RD, level);
+                break;
+            case GB_CART_SIGNAL_WR:
+                gb_cart_native_write(GB_NATIVE_WR_PIN, GB_CART_TRACE_PIN_WR, level);
+                break;
+            case GB_CART_SIGNAL_CS:
+                gb_cart_native_write(GB_NATIVE_CS_PIN, GB_CART_TRACE_PIN_CS, level);
+                gb_cart_native_cs = level;
+                break;
+        }
+        return;
+    }
     
+    static const uint8_t pins[] = {GB_MCP2_RD_PIN, GB_MCP2_WR_PIN, GB_MCP2_CS_PIN};
+    mcp23s17_digital_write(mcp2, pins[signal], GB_MCP2_DATA_PORT, level);
+}
+
+// Función para elegir la tensión del slot. Se comprueba leyendo el pin: con la
+// tensión equivocada no se debe hacer ningún ciclo de bus
+bool gb_cart_set_voltage(GBCartVoltage voltage) {
+    const uint8_t pin = 1 << GB_MCP2_VOLTAGE_PIN;
+    uint8_t level = (voltage == GB_CART_VOLTAGE_3V3) ? pin : 0;
+    uint8_t gpio = 0;
+    
+    if (!mcp23s17_update_pins(mcp2, GB_MCP2_DATA_PORT, pin, level) ||
+        !mcp23s17_read_reg(mcp2, MCP23S17_GPIOA, &gpio) || (gpio & pin) != level) {
+        FURI_LOG_E("GB_CART", "No se pudo seleccionar %s en el slot",
+                   voltage == GB_CART_VOLTAGE_3V3 ? "3,3 V" : "5 V");
+        return false;
+    }
+    
+    furi_delay_ms(GB_CART_VOLTAGE_SETTLE_MS);
     return true;
 }
 
+// Dirección en el cableado híbrido: sólo el backend (nada si no ha cambiado)
+// y el CS nativo. RD y WR ya están en reposo al terminar cada acceso
+static bool gb_cart_set_address_hybrid(uint16_t address) {
+    bool result = gb_address_set(address_backend, address);
+    
+    bool cs = address < 0xA000;
+    if (cs != gb_cart_native_cs) {
+        gb_cart_native_write(GB_NATIVE_CS_PIN, GB_CART_TRACE_PIN_CS, cs);
+        gb_cart_native_cs = cs;
+    }
+    return result;
+}
+
 // Función para establecer la dirección del cartucho
 void gb_cart_set_address(uint16_t address) {
-    // Establecer dirección en MCP1
-    uint8_t addr_low = address & 0xFF;
-    uint8_t addr_high = (address >> 8) & 0xFF;
+    if (gb_cart_wiring == GB_CART_WIRING_HYBRID) {
+        gb_cart_set_address_hybrid(address);
+        return;
+    }
     
-    mcp23s17_write_port(mcp1, MCP1_ADDR_LOW_PORT, addr_low);
-    mcp23s17_write_port(mcp1, MCP1_ADDR_HIGH_PORT, addr_high);
+    // Establecer dirección (MCP1 o 74HC595)
+    gb_address_set(address_backend, address);
     
     // Establecer señales de control en MCP2
+    // CS sólo se activa en 0xA000-0xFFFF, igual que en la consola, para que
+    // las escrituras a registros del MBC no seleccionen la RAM
     mcp23s17_digital_write(mcp2, GB_MCP2_RD_PIN, GB_MCP2_DATA_PORT, 1);  // RD
-    mcp23s17_digital_write(mcp2, GB_MCP2_WR_PIN, GB_MCP2_DATA_PORT, 0);  // WR
-    mcp23s17_digital_write(mcp2, GB_MCP2_CS_PIN, GB_MCP2_DATA_PORT, 0);  // CS
+    mcp23s17_digital_write(mcp2, GB_MCP2_WR_PIN, GB_MCP2_DATA_PORT, 1);  // WR
+    mcp23s17_digital_write(mcp2, GB_MCP2_CS_PIN, GB_MCP2_DATA_PORT, address < 0xA000);  // CS
 }
 
 // Función para leer un byte del cartucho
 bool gb_cart_read_byte(uint16_t address, uint8_t* value) {
     if (!value) return false;
     
+    if (gb_cart_wiring == GB_CART_WIRING_HYBRID) {
+        // Dirección (si cambia) y una única lectura del puerto de datos
+        uint8_t data = 0xFF;
+        bool result = gb_cart_set_address_hybrid(address);
+        // D0-D7 a entrada si la última operación fue una escritura
+        result = mcp23s17_update_reg(mcp2, MCP23S17_IODIRB, 0xFF) && result;
+        gb_cart_native_write(GB_NATIVE_RD_PIN, GB_CART_TRACE_PIN_RD, false);
+        result = mcp23s17_read_reg(mcp2, MCP23S17_GPIOB, &data) && result;
+        gb_cart_native_write(GB_NATIVE_RD_PIN, GB_CART_TRACE_PIN_RD, true);
+        *value = data;
+        return result;
+    }
+    
     gb_cart_set_address(address);
+    // D0-D7 a entrada si la última operación fue una escritura
+    mcp23s17_update_reg(mcp2, MCP23S17_IODIRB, 0xFF);
     
     // Esperar a que la dirección se estabilice
     // furi_delay_ms(3);
@@ -178,8 +260,8 @@ bool gb_cart_read_byte(uint16_t address, uint8_t* value) {
     // furi_delay_ms(3);
     
     // Leer datos de MCP2 (D0-D7 en GPB0-GPB7)
-    uint8_t data;
-    mcp23s17_read_port(mcp2, GB_MCP2_DATA_HIGH_PORT, &data);
+    uint8_t data = 0xFF;
+    bool result = mcp23s17_read_port(mcp2, GB_MCP2_DATA_HIGH_PORT, &data);
     
     // Desactivar RD
     mcp23s17_digital_write(mcp2, GB_MCP2_RD_PIN, GB_MCP2_DATA_PORT, 1);  // RD
@@ -188,56 +270,38 @@ bool gb_cart_read_byte(uint16_t address, uint8_t* value) {
     // furi_delay_ms(3);
     
     *value = data;
-    return true;
+    return result;
 }
 
-// Función para escribir un byte al cartucho
+// Función para escribir un byte al cartucho. D0-D7 (GPB) se quedan como
+// salida hasta la siguiente lectura: una ráfaga de escrituras a registros del
+// MBC sólo cambia la dirección del puerto una vez. Las señales se mueven desde
+// la cache de OLATA, sin leer de vuelta
 void gb_cart_write_byte(uint16_t address, uint8_t value) {
-    gb_cart_set_address(address);
+    if (gb_cart_wiring == GB_CART_WIRING_HYBRID) {
+        gb_cart_set_address_hybrid(address);
+        mcp23s17_update_reg(mcp2, MCP23S17_IODIRB, 0x00);
+        mcp23s17_write_reg(mcp2, MCP23S17_OLATB, value);
+        gb_cart_native_write(GB_NATIVE_WR_PIN, GB_CART_TRACE_PIN_WR, false);
+        gb_cart_native_write(GB_NATIVE_WR_PIN, GB_CART_TRACE_PIN_WR, true);
+        return;
+    }
     
-    // Escribir datos en MCP2
-    mcp23s17_write_port(mcp2, GB_MCP2_DATA_PORT, value);
-    mcp23s17_write_port(mcp2, GB_MCP2_DATA_HIGH_PORT, 0);
+    gb_address_set(address_backend, address);
     
-    // Establecer WR
-    mcp23s17_digital_write(mcp2, GB_MCP2_WR_PIN, GB_MCP2_DATA_PORT, 1);  // WR
-    mcp23s17_digital_write(mcp2, GB_MCP2_WR_PIN, GB_MCP2_DATA_PORT, 0);  // WR
-}
-
-// Función para obtener el string del tipo de cartucho
-uint8_t gb_cart_get_type_string(char* buffer, uint8_t type) {
-    switch(type) {
-        case 0x00: strcpy(buffer, "ROM ONLY"); return 8;
-        case 0x01: strcpy(buffer, "MBC1"); return 4;
-        case 0x02: strcpy(buffer, "MBC1+RAM"); return 8;
-        case 0x03: strcpy(buffer, "MBC1+RAM+BATTERY"); return 16;
-        case 0x05: strcpy(buffer, "MBC2"); return 4;
-        case 0x06: strcpy(buffer, "MBC2+BATTERY"); return 12;
-        case 0x08: strcpy(buffer, "ROM+RAM"); return 7;
-        case 0x09: strcpy(buffer, "ROM+RAM+BATTERY"); return 15;
-        case 0x0B: strcpy(buffer, "MMM01"); return 5;
-        case 0x0C: strcpy(buffer, "MMM01+RAM"); return 9;
-        case 0x0D: strcpy(buffer, "MMM01+RAM+BATTERY"); return 17;
-        case 0x0F: strcpy(buffer, "MBC3+TIMER+BATTERY"); return 17;
-        case 0x10: strcpy(buffer, "MBC3+TIMER+RAM+BATTERY"); return 21;
-        case 0x11: strcpy(buffer, "MBC3"); return 4;
-        case 0x12: strcpy(buffer, "MBC3+RAM"); return 8;
-        case 0x13: strcpy(buffer, "MBC3+RAM+BATTERY"); return 16;
-        case 0x15: strcpy(buffer, "MBC4"); return 4;
-        case 0x16: strcpy(buffer, "MBC4+RAM"); return 8;
-        case 0x17: strcpy(buffer, "MBC4+RAM+BATTERY"); return 16;
-        case 0x19: strcpy(buffer, "MBC5"); return 4;
-        case 0x1A: strcpy(buffer, "MBC5+RAM"); return 8;
-        case 0x1B: strcpy(buffer, "MBC5+RAM+BATTERY"); return 16;
-        case 0x1C: strcpy(buffer, "MBC5+RUMBLE"); return 11;
-        case 0x1D: strcpy(buffer, "MBC5+RUMBLE+RAM"); return 15;
-        case 0x1E: strcpy(buffer, "MBC5+RUMBLE+RAM+BATTERY"); return 23;
-        case 0xFC: strcpy(buffer, "POCKET CAMERA"); return 12;
-        case 0xFD: strcpy(buffer, "BANDAI TAMA5"); return 11;
-        case 0xFE: strcpy(buffer, "HuC3"); return 4;
-        case 0xFF: strcpy(buffer, "HuC1+RAM+BATTERY"); return 15;
-        default: strcpy(buffer, "UNKNOWN"); return 7;
-    }
+    // RD y WR en reposo, CS según la dirección (ver gb_cart_set_address)
+    const uint8_t control = (1 << GB_MCP2_RD_PIN) | (1 << GB_MCP2_WR_PIN) | (1 << GB_MCP2_CS_PIN);
+    uint8_t idle = (1 << GB_MCP2_RD_PIN) | (1 << GB_MCP2_WR_PIN) |
+                   ((address < 0xA000) ? (1 << GB_MCP2_CS_PIN) : 0);
+    mcp23s17_update_pins(mcp2, GB_MCP2_DATA_PORT, control, idle);
+    
+    // D0-D7 como salida (si no lo estaban ya) y el dato
+    mcp23s17_update_reg(mcp2, MCP23S17_IODIRB, 0x00);
+    mcp23s17_write_reg(mcp2, MCP23S17_OLATB, value);
+    
+    // Pulso de WR (activo en bajo)
+    mcp23s17_update_pins(mcp2, GB_MCP2_DATA_PORT, 1 << GB_MCP2_WR_PIN, 0);
+    mcp23s17_update_pins(mcp2, GB_MCP2_DATA_PORT, 1 << GB_MCP2_WR_PIN, 1 << GB_MCP2_WR_PIN);
 }
 
 // Función para leer múltiples bytes del cartucho
@@ -252,6 +316,23 @@ bool gb_cart_read_bytes(uint16_t address, uint8_t* buffer, size_t length) {
     return true;
 }
 
+// Comprueba los primeros 'length' bytes del logo de Nintendo: sirve para saber
+// si hay un cartucho insertado y con buen contacto
+bool gb_cart_check_logo(uint8_t length) {
+    if (length > GB_CART_LOGO_SIZE) length = GB_CART_LOGO_SIZE;
+    
+    uint8_t logo[GB_CART_LOGO_SIZE];
+    if (!gb_cart_read_bytes(GB_CART_LOGO_START, logo, length)) {
+        return false;
+    }
+    return gb_cart_logo_matches(logo, length);
+}
+
+// Comprueba que los dos MCP23S17 siguen respondiendo por SPI
+bool gb_cart_bus_ok(void) {
+    return gb_address_is_connected(address_backend) && mcp23s17_is_connected(mcp2);
+}
+
 // Función principal para leer la información del cartucho
 bool gb_cart_read_info(GBCartInfo* info) {
     if (!info) return false;
@@ -265,78 +346,9 @@ bool gb_cart_read_info(GBCartInfo* info) {
     
     FURI_LOG_I("GB_CART", "Leído 0x0 - 0x0180");
     
-    // Limpiar el título
-    memset(info->title, 0, sizeof(info->title));
-    
-    // Leer el título del cartucho (0x0134 - 0x0143)
-    uint8_t titleLength = 0;
-    for (uint16_t titleAddress = 0x0134; titleAddress <= 0x0143; titleAddress++) {
-        char headerChar = startRomBuffer[titleAddress];
-
-        FURI_LOG_I("GB_CART", "Char: %d", headerChar);
-        if ((headerChar >= 0x30 && headerChar <= 0x39) || // 0-9
-            (headerChar >= 0x41 && headerChar <= 0x5A) || // A-Z
-            (headerChar >= 0x61 && headerChar <= 0x7A) || // a-z
-            (headerChar >= 0x24 && headerChar <= 0x29) || // #$%&'()
-            (headerChar == 0x2D) ||                       // -
-            (headerChar == 0x2E) ||                       // .
-            (headerChar == 0x5F) ||                       // _
-            (headerChar == 0x20)) {                       // Space
-            info->title[titleAddress - 0x0134] = headerChar;
-            titleLength++;
-        }
-        // Reemplazar con guión bajo
-        else if (headerChar == 0x3A) {
-            info->title[titleAddress - 0x0134] = '_';
-            titleLength++;
-        }
-        else {
-            info->title[titleAddress - 0x0134] = '\0';
-            break;
-        }
-    }
-    
-    // Leer el tipo de cartucho (offset 0x147)
-    info->cart_type = startRomBuffer[0x147];
-    
-    // Leer el tamaño de ROM (offset 0x148)
-    uint8_t rom_size_code = startRomBuffer[0x148];
-    info->rom_size = 32768 << rom_size_code;  // 32KB * 2^rom_size_code
-    info->rom_banks = info->rom_size / 32768;  // Cada banco es de 32KB
-    
-    // Leer el tamaño de RAM (offset 0x149)
-    uint8_t ram_size_code = startRomBuffer[0x149];
-    switch (ram_size_code) {
-        case 0: info->ram_size = 0; break;
-        case 1: info->ram_size = 2048; break;    // 2KB
-        case 2: info->ram_size = 8192; break;    // 8KB
-        case 3: info->ram_size = 32768; break;   // 32KB
-        default: info->ram_size = 0; break;
-    }
-    info->ram_banks = info->ram_size / 8192;  // Cada banco es de 8KB
-    
-    // Verificar características
-    info->has_battery = (info->cart_type == 0x03 || // MBC1+RAM+BATTERY
-                        info->cart_type == 0x06 || // MBC2+BATTERY
-                        info->cart_type == 0x09 || // ROM+RAM+BATTERY
-                        info->cart_type == 0x0D || // MMM01+RAM+BATTERY
-                        info->cart_type == 0x0F || // MBC3+TIMER+BATTERY
-                        info->cart_type == 0x10 || // MBC3+TIMER+RAM+BATTERY
-                        info->cart_type == 0x13 || // MBC3+RAM+BATTERY
-                        info->cart_type == 0x17 || // MBC4+RAM+BATTERY
-                        info->cart_type == 0x1B || // MBC5+RAM+BATTERY
-                        info->cart_type == 0x1E || // MBC5+RUMBLE+RAM+BATTERY
-                        info->cart_type == 0xFF);  // HuC1+RAM+BATTERY
-    
-    // Verificar SGB (offset 0x146)
-    info->has_sgb = (startRomBuffer[0x146] == 0x03);
-    
-    // Calcular checksum
-    uint16_t checksum = 0;
-    for (int i = 0x134; i <= 0x14C; i++) {
-        checksum += startRomBuffer[i];
+    if (!gb_cart_parse_header(startRomBuffer, sizeof(startRomBuffer), info)) {
+        return false;
     }
-    info->checksum = checksum & 0xFF;
     
     FURI_LOG_I("GB_CART", "Título: %s", info->title);
     FURI_LOG_I("GB_CART", "Tipo: 0x%02X", info->cart_type);
@@ -345,6 +357,9 @@ bool gb_cart_read_info(GBCartInfo* info) {
     FURI_LOG_I("GB_CART", "Batería: %s", info->has_battery ? "Sí" : "No");
     FURI_LOG_I("GB_CART", "SGB: %s", info->has_sgb ? "Sí" : "No");
     FURI_LOG_I("GB_CART", "Checksum: 0x%02X", info->checksum);
+    if (!info->header_checksum_ok) {
+        FURI_LOG_W("GB_CART", "Checksum del header incorrecto (0x%02X)", info->header_checksum);
+    }
     
     return true;
 } 
\ No newline at end of file
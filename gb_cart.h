@@ -3,66 +3,60 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "mcp23s17_api.h"
+#include "gb_address.h"
+#include "gb_header.h"
 
-// Estructura para almacenar la información del cartucho
-typedef struct {
-    char title[17];
-    uint8_t checksum;
-    bool has_sgb;
-    bool is_gbc;
-    char serial[4];
-    uint8_t ram_banks;
-    uint8_t rom_banks;
-    uint8_t cart_type;
-    bool has_battery;
-    uint32_t rom_size;
-    uint32_t ram_size;
-} GBCartInfo;
+// Cableado de las señales RD, WR y CS del cartucho
+typedef enum {
+    GB_CART_WIRING_MCP = 0,  // Todas en el puerto A del MCP2
+    GB_CART_WIRING_HYBRID,   // RD=PC0, WR=PC1, CS=PB2 (GPIO nativo del Flipper)
+    GB_CART_WIRING_COUNT
+} GBCartWiring;
 
-// Constantes para el cartucho
-#define GB_CART_TITLE_START 0x134
-#define GB_CART_TITLE_END 0x143
-#define GB_CART_SGB_FLAG 0x146
-#define GB_CART_CART_TYPE 0x147
-#define GB_CART_ROM_SIZE 0x148
-#define GB_CART_RAM_SIZE 0x149
-#define GB_CART_DEST_CODE 0x14A
-#define GB_CART_LICENSE_CODE 0x14B
-#define GB_CART_VERSION 0x14C
-#define GB_CART_CHECKSUM 0x14E
-#define GB_CART_GLOBAL_CHECKSUM 0x14E
+// Señales de control compartidas con el lector de GBA
+typedef enum {
+    GB_CART_SIGNAL_RD = 0,
+    GB_CART_SIGNAL_WR,
+    GB_CART_SIGNAL_CS
+} GBCartSignal;
 
-// Tipos de cartucho
-#define GB_CART_TYPE_ROM_ONLY 0x00
-#define GB_CART_TYPE_MBC1 0x01
-#define GB_CART_TYPE_MBC1_RAM 0x02
-#define GB_CART_TYPE_MBC1_RAM_BATTERY 0x03
-#define GB_CART_TYPE_MBC2 0x05
-#define GB_CART_TYPE_MBC2_BATTERY 0x06
-#define GB_CART_TYPE_ROM_RAM 0x08
-#define GB_CART_TYPE_ROM_RAM_BATTERY 0x09
-#define GB_CART_TYPE_MMM01 0x0B
-#define GB_CART_TYPE_MMM01_RAM 0x0C
-#define GB_CART_TYPE_MMM01_RAM_BATTERY 0x0D
-#define GB_CART_TYPE_MBC3_TIMER_BATTERY 0x0F
-#define GB_CART_TYPE_MBC3_TIMER_RAM_BATTERY 0x10
-#define GB_CART_TYPE_MBC3 0x11
-#define GB_CART_TYPE_MBC3_RAM 0x12
-#define GB_CART_TYPE_MBC3_RAM_BATTERY 0x13
-#define GB_CART_TYPE_MBC5 0x19
-#define GB_CART_TYPE_MBC5_RAM 0x1A
-#define GB_CART_TYPE_MBC5_RAM_BATTERY 0x1B
-#define GB_CART_TYPE_MBC5_RUMBLE 0x1C
-#define GB_CART_TYPE_MBC5_RUMBLE_RAM 0x1D
-#define GB_CART_TYPE_MBC5_RUMBLE_RAM_BATTERY 0x1E
+// Tensión del slot, elegida con VOLTAGE_SELECT (GPA6 del MCP2): a 0 el
+// regulador da 5 V (Game Boy / Color) y a 1 da 3,3 V (Game Boy Advance)
+typedef enum {
+    GB_CART_VOLTAGE_5V = 0,
+    GB_CART_VOLTAGE_3V3 = 1
+} GBCartVoltage;
+
+// Espera a que el regulador se estabilice tras cambiar de tensión
+#define GB_CART_VOLTAGE_SETTLE_MS 20
+
+// Cableado por defecto; se puede cambiar al compilar (cdefines en application.fam)
+#ifndef GB_CART_DEFAULT_WIRING
+#define GB_CART_DEFAULT_WIRING GB_CART_WIRING_MCP
+#endif
+
+// Identificadores de los pines nativos en la traza del bus (MCP23S17_TRACE_CHIP_GPIO)
+#define GB_CART_TRACE_PIN_RD 0
+#define GB_CART_TRACE_PIN_WR 1
+#define GB_CART_TRACE_PIN_CS 2
 
 // Funciones para leer el cartucho
-bool gb_cart_init(MCP23S17* mcp1, MCP23S17* mcp2);
+bool gb_cart_init(GBAddressBackend* address, MCP23S17* mcp2);
+bool gb_cart_set_address_backend(GBAddressBackend* address);
+void gb_cart_deinit(void);
 bool gb_cart_read_info(GBCartInfo* info);
 bool gb_cart_read_byte(uint16_t address, uint8_t* value);
+bool gb_cart_read_bytes(uint16_t address, uint8_t* buffer, size_t length);
 void gb_cart_write_byte(uint16_t address, uint8_t value);
 void gb_cart_set_address(uint16_t address);
-uint8_t gb_cart_get_type_string(char* buffer, uint8_t type);
+bool gb_cart_check_logo(uint8_t length);
+bool gb_cart_bus_ok(void);
+bool gb_cart_set_wiring(GBCartWiring wiring);
+GBCartWiring gb_cart_get_wiring(void);
+const char* gb_cart_get_wiring_name(GBCartWiring wiring);
+void gb_cart_set_signal(GBCartSignal signal, bool level);
+bool gb_cart_set_voltage(GBCartVoltage voltage);
 
 #endif // GB_CART_H 
\ No newline at end of file
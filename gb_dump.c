@@ -0,0 +1,514 @@
+#include "gb_dump.h"
+#include "gb_lz.h"
+#include <storage/storage.h>
+#include <furi_hal_random.h>
+#include <string.h>
+
+// Salida del volcado: archivo directo o comprimido en streaming
+typedef struct {
+    File* file;
+    GBLzEncoder* encoder;    // NULL si el formato es RAW
+    uint32_t bytes_written;
+} GBDumpWriter;
+
+static bool gb_dump_file_write(const uint8_t* data, size_t length, void* context) {
+    GBDumpWriter* writer = context;
+    if(storage_file_write(writer->file, data, length) != length) return false;
+    writer->bytes_written += length;
+    return true;
+}
+
+static bool gb_dump_writer_open(GBDumpWriter* writer, Storage* storage, const char* path, GBDumpFormat format) {
+    memset(writer, 0, sizeof(GBDumpWriter));
+    writer->file = storage_file_alloc(storage);
+    if(!storage_file_open(writer->file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E("GB_DUMP", "No se pudo crear %s", path);
+        return false;
+    }
+    if(format == GB_DUMP_FORMAT_GBZ) {
+        writer->encoder = malloc(sizeof(GBLzEncoder));
+        gb_lz_encoder_init(writer->encoder, gb_dump_file_write, writer);
+    }
+    return true;
+}
+
+static bool gb_dump_writer_write(GBDumpWriter* writer, const uint8_t* data, size_t length) {
+    if(writer->encoder) {
+        return gb_lz_encoder_write(writer->encoder, data, length);
+    }
+    return gb_dump_file_write(data, length, writer);
+}
+
+static bool gb_dump_writer_close(GBDumpWriter* writer, bool finish) {
+    bool success = true;
+    if(writer->encoder) {
+        if(finish) success = gb_lz_encoder_finish(writer->encoder);
+        free(writer->encoder);
+    }
+    storage_file_close(writer->file);
+    storage_file_free(writer->file);
+    return success;
+}
+
+// Lee el centinela: primeros bytes del logo y checksums del header (0x14D-0x14F).
+// Se lee a través del mapper para que MBC1 en modo 1 no muestre otro banco
+static bool gb_dump_read_sentinel(GBMapper* mapper, uint8_t* checksums) {
+    uint8_t logo[GB_DUMP_SENTINEL_LOGO_BYTES];
+    if(!gb_mapper_read_rom(mapper, GB_CART_LOGO_START, logo, sizeof(logo))) return false;
+    if(!gb_cart_logo_matches(logo, sizeof(logo))) return false;
+    return gb_mapper_read_rom(mapper, GB_CART_HEADER_CHECKSUM, checksums, 3);
+}
+
+static bool gb_dump_check_sentinel(GBMapper* mapper, const uint8_t* reference) {
+    uint8_t checksums[3];
+    return gb_dump_read_sentinel(mapper, checksums) && memcmp(checksums, reference, 3) == 0;
+}
+
+// Un bloque todo 0xFF o todo 0x00 puede ser relleno o bus abierto: se comprueba
+static bool gb_dump_is_open_bus(const uint8_t* buffer, size_t length) {
+    if(buffer[0] != 0xFF && buffer[0] != 0x00) return false;
+    for(size_t i = 1; i < length; i++) {
+        if(buffer[i] != buffer[0]) return false;
+    }
+    return true;
+}
+
+// Espera a que vuelva el mismo cartucho (dos lecturas buenas seguidas)
+static GBDumpError gb_dump_wait_reseat(
+    GBMapper* mapper,
+    const uint8_t* reference,
+    uint32_t done,
+    uint32_t total,
+    GBDumpProgressCallback callback,
+    void* context) {
+    uint32_t start = furi_get_tick();
+    uint8_t good_reads = 0;
+    while(furi_get_tick() - start < furi_ms_to_ticks(GB_DUMP_RESEAT_TIMEOUT_MS)) {
+        // Se avisa en cada sondeo para poder cancelar durante la pausa
+        if(callback && !callback(done, total, true, context)) return GB_DUMP_ERROR_ABORTED;
+        furi_delay_ms(GB_DUMP_RESEAT_POLL_MS);
+        // Al reinsertar el cartucho el MBC vuelve a su estado de reset
+        gb_mapper_invalidate(mapper);
+        if(!gb_dump_check_sentinel(mapper, reference)) {
+            good_reads = 0;
+        } else if(++good_reads >= 2) {
+            FURI_LOG_I("GB_DUMP", "Cartucho de nuevo en contacto, continuando");
+            if(callback && !callback(done, total, false, context)) return GB_DUMP_ERROR_ABORTED;
+            return GB_DUMP_OK;
+        }
+    }
+
+    return gb_cart_bus_ok() ? GB_DUMP_ERROR_CART_REMOVED : GB_DUMP_ERROR_BUS;
+}
+
+// Lee 'total' bytes con la función de lectura del mapper y los escribe a la SD.
+// Los bloques se acumulan y sólo se escriben tras comprobar el centinela; si el
+// cartucho se pierde se descartan, se pausa y se continúa desde el último
+// bloque verificado
+static bool gb_dump_region(
+    GBMapper* mapper,
+    bool (*read)(GBMapper* mapper, uint32_t offset, uint8_t* buffer, size_t length),
+    uint32_t total,
+    const char* path,
+    GBDumpFormat format,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBDumpResult* result) {
+    uint8_t reference[3];
+    if(!gb_dump_read_sentinel(mapper, reference)) {
+        FURI_LOG_E("GB_DUMP", "No hay cartucho (logo incorrecto)");
+        result->error = GB_DUMP_ERROR_NO_CART;
+        return false;
+    }
+
+    const size_t staging_size = GB_DUMP_SENTINEL_INTERVAL * GB_DUMP_CHUNK_SIZE;
+    uint8_t* staging = malloc(staging_size);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    GBDumpWriter writer;
+    result->error = GB_DUMP_OK;
+
+    if(!gb_dump_writer_open(&writer, storage, path, format)) {
+        result->error = GB_DUMP_ERROR_STORAGE;
+    }
+
+    uint32_t committed = 0;
+    size_t staged = 0;
+    while(result->error == GB_DUMP_OK && committed < total) {
+        uint32_t offset = committed + staged;
+        size_t chunk = (total - offset < GB_DUMP_CHUNK_SIZE) ? total - offset : GB_DUMP_CHUNK_SIZE;
+        uint8_t* buffer = &staging[staged];
+        bool read_ok = read(mapper, offset, buffer, chunk);
+        staged += chunk;
+
+        // Comprobar el centinela si el bloque es sospechoso, si el buffer se
+        // llenó o si es el final
+        bool check = !read_ok || gb_dump_is_open_bus(buffer, chunk) || staged == staging_size ||
+                     offset + chunk == total;
+        if(!check) continue;
+
+        if(!read_ok || !gb_dump_check_sentinel(mapper, reference)) {
+            FURI_LOG_W("GB_DUMP", "Cartucho sin contacto cerca de 0x%06lX, en pausa", offset);
+            result->error_offset = offset;
+            result->pauses++;
+            staged = 0;
+            result->error = gb_dump_wait_reseat(mapper, reference, committed, total, callback, context);
+            continue;
+        }
+
+        if(!gb_dump_writer_write(&writer, staging, staged)) {
+            FURI_LOG_E("GB_DUMP", "Error de escritura en la SD");
+            result->error = GB_DUMP_ERROR_STORAGE;
+            result->error_offset = committed;
+            break;
+        }
+        committed += staged;
+        staged = 0;
+        result->bytes_read = committed;
+
+        if(callback && !callback(committed, total, false, context)) {
+            result->error = GB_DUMP_ERROR_ABORTED;
+            result->error_offset = committed;
+        }
+    }
+
+    bool success = (result->error == GB_DUMP_OK && committed == total);
+    if(!gb_dump_writer_close(&writer, success) && success) {
+        result->error = GB_DUMP_ERROR_STORAGE;
+        success = false;
+    }
+    result->bytes_written = writer.bytes_written;
+    furi_record_close(RECORD_STORAGE);
+    free(staging);
+
+    if(success) {
+        FURI_LOG_I(
+            "GB_DUMP",
+            "Volcado: %lu bytes -> %lu bytes en %s",
+            result->bytes_read,
+            result->bytes_written,
+            path);
+    } else {
+        FURI_LOG_E(
+            "GB_DUMP",
+            "Volcado abortado en 0x%06lX: %s",
+            result->error_offset,
+            gb_dump_get_error_string(result->error));
+    }
+    return success;
+}
+
+// Vuelca la ROM completa a un archivo usando el tamaño real detectado
+bool gb_dump_rom(
+    GBMapper* mapper,
+    const GBCartInfo* info,
+    const char* path,
+    GBDumpFormat format,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBDumpResult* result) {
+    if(!mapper || !info || !path || !result) return false;
+
+    memset(result, 0, sizeof(GBDumpResult));
+    result->header_size = info->rom_size;
+
+    // Detectar el tamaño real antes de empezar, en vez de confiar en 0x148.
+    // La presencia del cartucho la comprueba gb_dump_region con el centinela
+    if(!gb_mapper_detect_rom_size(mapper, &result->detected_size)) {
+        FURI_LOG_E("GB_DUMP", "Error al detectar el tamaño de la ROM");
+        result->error = GB_DUMP_ERROR_SIZE;
+        return false;
+    }
+    result->size_mismatch = (result->detected_size != result->header_size);
+    if(result->size_mismatch) {
+        FURI_LOG_W(
+            "GB_DUMP",
+            "El header indica %luKB pero la ROM tiene %luKB",
+            result->header_size / 1024,
+            result->detected_size / 1024);
+    }
+    mapper->rom_size = result->detected_size;
+
+    return gb_dump_region(
+        mapper, gb_mapper_read_rom, result->detected_size, path, format, callback, context, result);
+}
+
+// Vuelca la RAM (partida guardada) del cartucho
+bool gb_dump_save(
+    GBMapper* mapper,
+    const char* path,
+    GBDumpFormat format,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBDumpResult* result) {
+    if(!mapper || !path || !result) return false;
+
+    memset(result, 0, sizeof(GBDumpResult));
+    result->header_size = mapper->ram_size;
+    result->detected_size = mapper->ram_size;
+    if(mapper->ram_size == 0) return false;
+
+    bool success = gb_dump_region(
+        mapper, gb_mapper_read_ram, mapper->ram_size, path, format, callback, context, result);
+
+    // No dejar la RAM habilitada al terminar
+    gb_mapper_disable_ram(mapper);
+    return success;
+}
+
+// Compara un bloque del cartucho con el mismo bloque del archivo. Devuelve
+// false si no se pudo leer alguno de los dos
+static bool gb_dump_verify_chunk(
+    GBMapper* mapper,
+    File* file,
+    uint32_t offset,
+    size_t length,
+    uint8_t* cart,
+    uint8_t* expected,
+    GBVerifyResult* result) {
+    if(!storage_file_seek(file, offset, true) || storage_file_read(file, expected, length) != length) {
+        result->error = GB_DUMP_ERROR_STORAGE;
+        return false;
+    }
+    if(!gb_mapper_read_rom(mapper, offset, cart, length)) {
+        result->error = GB_DUMP_ERROR_BUS;
+        return false;
+    }
+    result->bytes_compared += length;
+    result->chunks_compared++;
+
+    if(memcmp(cart, expected, length) == 0) return true;
+
+    size_t i = 0;
+    while(cart[i] == expected[i]) i++;
+    result->match = false;
+    result->mismatch_offset = offset + i;
+    result->cart_value = cart[i];
+    result->file_value = expected[i];
+    return true;
+}
+
+// Compara la ROM del cartucho con un volcado RAW de la SD, bloque a bloque y
+// a través del mapper. Si el archivo no mide lo mismo que la ROM detectada no
+// se compara nada (size_mismatch). Se detiene en la primera diferencia. Si la diferencia
+// coincide con una pérdida de contacto se informa como cartucho retirado, no
+// como ROM distinta. En modo muestreo compara el primer bloque, el último y
+// GB_DUMP_VERIFY_SAMPLES bloques al azar
+bool gb_dump_verify_rom(
+    GBMapper* mapper,
+    const char* path,
+    bool sampled,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBVerifyResult* result) {
+    if(!mapper || !path || !result) return false;
+
+    memset(result, 0, sizeof(GBVerifyResult));
+    result->sampled = sampled;
+    result->match = true;
+
+    uint8_t reference[3];
+    if(!gb_dump_read_sentinel(mapper, reference)) {
+        FURI_LOG_E("GB_DUMP", "No hay cartucho (logo incorrecto)");
+        result->error = GB_DUMP_ERROR_NO_CART;
+        result->match = false;
+        return false;
+    }
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E("GB_DUMP", "No se pudo abrir %s", path);
+        result->error = GB_DUMP_ERROR_STORAGE;
+    } else {
+        result->file_size = storage_file_size(file);
+        if(result->file_size == 0 || result->file_size > gb_mapper_max_rom_size(mapper->type)) {
+            FURI_LOG_E("GB_DUMP", "%s no cabe en un %s", path, gb_mapper_get_name(mapper->type));
+            result->error = GB_DUMP_ERROR_SIZE;
+        } else if(!gb_mapper_detect_rom_size(mapper, &result->cart_size)) {
+            result->error = GB_DUMP_ERROR_BUS;
+        } else if(result->file_size != result->cart_size) {
+            // Un .gb truncado o de otra ROM más pequeña coincidiría bloque a
+            // bloque: se descarta antes de comparar
+            FURI_LOG_W(
+                "GB_DUMP",
+                "%s tiene %luKB pero la ROM tiene %luKB",
+                path,
+                result->file_size / 1024,
+                result->cart_size / 1024);
+            result->size_mismatch = true;
+            result->match = false;
+        }
+    }
+
+    uint8_t* cart = malloc(GB_DUMP_CHUNK_SIZE);
+    uint8_t* expected = malloc(GB_DUMP_CHUNK_SIZE);
+    uint32_t chunks = (result->file_size + GB_DUMP_CHUNK_SIZE - 1) / GB_DUMP_CHUNK_SIZE;
+    uint32_t steps = (sampled && chunks > GB_DUMP_VERIFY_SAMPLES + 2) ? GB_DUMP_VERIFY_SAMPLES + 2 : chunks;
+
+    for(uint32_t step = 0; result->error == GB_DUMP_OK && result->match && step < steps; step++) {
+        uint32_t chunk = step;
+        if(steps < chunks) {
+            // Primero y último fijos (header y final de la ROM); el resto al azar
+            if(step == 1) {
+                chunk = chunks - 1;
+            } else if(step > 1) {
+                chunk = furi_hal_random_get() % chunks;
+            }
+        }
+        uint32_t offset = chunk * GB_DUMP_CHUNK_SIZE;
+        size_t length = (result->file_size - offset < GB_DUMP_CHUNK_SIZE) ? result->file_size - offset :
+                                                                             GB_DUMP_CHUNK_SIZE;
+        if(!gb_dump_verify_chunk(mapper, file, offset, length, cart, expected, result)) break;
+
+        // Una diferencia con el cartucho fuera de contacto no dice nada de la ROM.
+        // Sólo aquí (lectura correcta con datos distintos) se distingue un
+        // cartucho retirado de un fallo del bus; una lectura fallida ya es BUS
+        if(!result->match && !gb_dump_check_sentinel(mapper, reference)) {
+            result->error = gb_cart_bus_ok() ? GB_DUMP_ERROR_CART_REMOVED : GB_DUMP_ERROR_BUS;
+        }
+        if(callback && !callback(step + 1, steps, false, context) && result->error == GB_DUMP_OK &&
+           result->match) {
+            result->error = GB_DUMP_ERROR_ABORTED;
+        }
+    }
+
+    free(expected);
+    free(cart);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(result->error != GB_DUMP_OK) {
+        result->match = false;
+        FURI_LOG_E("GB_DUMP", "Verificación abortada: %s", gb_dump_get_error_string(result->error));
+        return false;
+    }
+    if(result->match) {
+        FURI_LOG_I(
+            "GB_DUMP",
+            "Verificación OK: %lu bytes en %lu bloques%s",
+            result->bytes_compared,
+            result->chunks_compared,
+            sampled ? " (muestreo)" : "");
+    } else if(!result->size_mismatch) {
+        FURI_LOG_W(
+            "GB_DUMP",
+            "Diferencia en 0x%06lX: cartucho 0x%02X, archivo 0x%02X",
+            result->mismatch_offset,
+            result->cart_value,
+            result->file_value);
+    }
+    return true;
+}
+
+// Centinela de GBA: del valor fijo 0x96 al checksum del header (0xB2-0xBD)
+#define GB_DUMP_GBA_SENTINEL_LENGTH (GBA_CART_CHECKSUM + 1 - GBA_CART_FIXED_VALUE)
+
+static bool gb_dump_gba_read_sentinel(uint8_t* sentinel) {
+    return gba_cart_read_rom(GBA_CART_FIXED_VALUE, sentinel, GB_DUMP_GBA_SENTINEL_LENGTH);
+}
+
+// Vuelca la ROM de un cartucho de GBA. No hay mapper: el bus de 24 bits
+// alcanza toda la ROM. Cada GB_DUMP_SENTINEL_INTERVAL bloques se relee el
+// header; si cambia se aborta (sin pausa: el bus multiplexado no garantiza
+// que el cartucho vuelva en el mismo estado)
+bool gb_dump_gba_rom(
+    const char* path,
+    GBDumpFormat format,
+    uint32_t size,
+    GBDumpDataCallback data_callback,
+    void* data_context,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBDumpResult* result) {
+    if(!path || !result || size == 0 || size > GBA_CART_MAX_ROM_SIZE) return false;
+
+    memset(result, 0, sizeof(GBDumpResult));
+    result->header_size = size;
+    result->detected_size = size;
+
+    uint8_t header[GBA_CART_HEADER_SIZE];
+    if(!gba_cart_read_rom(0, header, sizeof(header)) || !gba_cart_header_valid(header)) {
+        FURI_LOG_E("GB_DUMP", "No hay cartucho de GBA (header incorrecto)");
+        result->error = GB_DUMP_ERROR_NO_CART;
+        return false;
+    }
+    uint8_t reference[GB_DUMP_GBA_SENTINEL_LENGTH];
+    memcpy(reference, &header[GBA_CART_FIXED_VALUE], sizeof(reference));
+
+    const size_t staging_size = GB_DUMP_SENTINEL_INTERVAL * GB_DUMP_CHUNK_SIZE;
+    uint8_t* staging = malloc(staging_size);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    GBDumpWriter writer;
+
+    if(!gb_dump_writer_open(&writer, storage, path, format)) {
+        result->error = GB_DUMP_ERROR_STORAGE;
+    }
+
+    uint32_t committed = 0;
+    while(result->error == GB_DUMP_OK && committed < size) {
+        size_t staged = (size - committed < staging_size) ? size - committed : staging_size;
+        bool read_ok = true;
+        for(size_t i = 0; read_ok && i < staged; i += GB_DUMP_CHUNK_SIZE) {
+            read_ok = gba_cart_read_rom(committed + i, &staging[i], GB_DUMP_CHUNK_SIZE);
+        }
+
+        uint8_t sentinel[GB_DUMP_GBA_SENTINEL_LENGTH];
+        if(!read_ok || !gb_dump_gba_read_sentinel(sentinel) ||
+           memcmp(sentinel, reference, sizeof(reference)) != 0) {
+            FURI_LOG_E("GB_DUMP", "Cartucho de GBA sin contacto cerca de 0x%07lX", committed);
+            result->error_offset = committed;
+            result->error = gb_cart_bus_ok() ? GB_DUMP_ERROR_CART_REMOVED : GB_DUMP_ERROR_BUS;
+            break;
+        }
+
+        if(data_callback) data_callback(staging, staged, data_context);
+        if(!gb_dump_writer_write(&writer, staging, staged)) {
+            FURI_LOG_E("GB_DUMP", "Error de escritura en la SD");
+            result->error = GB_DUMP_ERROR_STORAGE;
+            result->error_offset = committed;
+            break;
+        }
+        committed += staged;
+        result->bytes_read = committed;
+
+        if(callback && !callback(committed, size, false, context)) {
+            result->error = GB_DUMP_ERROR_ABORTED;
+            result->error_offset = committed;
+        }
+    }
+
+    bool success = (result->error == GB_DUMP_OK && committed == size);
+    if(!gb_dump_writer_close(&writer, success) && success) {
+        result->error = GB_DUMP_ERROR_STORAGE;
+        success = false;
+    }
+    result->bytes_written = writer.bytes_written;
+    furi_record_close(RECORD_STORAGE);
+    free(staging);
+
+    if(success) {
+        FURI_LOG_I("GB_DUMP", "Volcado GBA: %lu bytes -> %lu bytes en %s", committed, writer.bytes_written, path);
+    } else {
+        FURI_LOG_E(
+            "GB_DUMP",
+            "Volcado GBA abortado en 0x%07lX: %s",
+            result->error_offset,
+            gb_dump_get_error_string(result->error));
+    }
+    return success;
+}
+
+// Texto corto del error para mostrar en pantalla
+const char* gb_dump_get_error_string(GBDumpError error) {
+    switch(error) {
+        case GB_DUMP_OK: return "OK";
+        case GB_DUMP_ERROR_STORAGE: return "Error SD";
+        case GB_DUMP_ERROR_NO_CART: return "Sin cartucho";
+        case GB_DUMP_ERROR_CART_REMOVED: return "Cartucho retirado";
+        case GB_DUMP_ERROR_BUS: return "Error bus SPI";
+        case GB_DUMP_ERROR_SIZE: return "Error tamano";
+        case GB_DUMP_ERROR_ABORTED: return "Cancelado";
+        default: return "Error";
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef GB_DUMP_H
+#define GB_DUMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gb_cart.h"
+#include "gb_mapper.h"
+#include "gba_cart.h"
+
+// Tamaño del bloque que se lee del cartucho y se escribe a la SD
+#define GB_DUMP_CHUNK_SIZE 512
+
+// Extensión añadida a los archivos comprimidos
+#define GB_DUMP_COMPRESSED_EXT ".gbz"
+
+// Comprobaciones de cartucho durante el volcado: cada cuántos bloques se
+// relee el centinela (logo + checksums del header) y cuánto se espera a que
+// el cartucho vuelva a estar bien insertado antes de abortar. Los bloques
+// sólo se escriben a la SD después de pasar el centinela
+#define GB_DUMP_SENTINEL_INTERVAL   4
+#define GB_DUMP_SENTINEL_LOGO_BYTES 8
+#define GB_DUMP_RESEAT_POLL_MS      100
+#define GB_DUMP_RESEAT_TIMEOUT_MS   30000
+
+// Verificación contra un archivo: en modo muestreo se comparan sólo
+// GB_DUMP_VERIFY_SAMPLES bloques elegidos al azar (más el primero y el último)
+#define GB_DUMP_VERIFY_SAMPLES 64
+
+// Formato de salida
+typedef enum {
+    GB_DUMP_FORMAT_RAW = 0,  // Copia exacta
+    GB_DUMP_FORMAT_GBZ = 1   // Comprimido en streaming (ver gb_lz.h)
+} GBDumpFormat;
+
+// Errores de volcado
+typedef enum {
+    GB_DUMP_OK = 0,
+    GB_DUMP_ERROR_STORAGE,       // No se pudo escribir en la SD
+    GB_DUMP_ERROR_NO_CART,       // No hay cartucho al empezar
+    GB_DUMP_ERROR_CART_REMOVED,  // Cartucho retirado o sin contacto y no volvió
+    GB_DUMP_ERROR_BUS,           // El bus SPI con los MCP23S17 falla
+    GB_DUMP_ERROR_SIZE,          // No se pudo detectar el tamaño
+    GB_DUMP_ERROR_ABORTED        // Cancelado desde el callback de progreso
+} GBDumpError;
+
+// Callback de progreso: bytes procesados y total. 'paused' indica que el
+// volcado está esperando a que se vuelva a insertar el cartucho. Devolver
+// false cancela la operación antes del siguiente bloque
+typedef bool (*GBDumpProgressCallback)(uint32_t done, uint32_t total, bool paused, void* context);
+
+// Callback con cada bloque ya verificado, antes de escribirlo (p. ej. para
+// buscar el tipo de partida de GBA mientras se vuelca la ROM)
+typedef void (*GBDumpDataCallback)(const uint8_t* data, size_t length, void* context);
+
+// Resultado de un volcado
+typedef struct {
+    uint32_t header_size;    // Tamaño declarado en el header (0x148/0x149)
+    uint32_t detected_size;  // Tamaño real (ROM: detectado por espejado de bancos)
+    uint32_t bytes_read;     // Bytes leídos del cartucho
+    uint32_t bytes_written;  // Bytes escritos en la SD
+    bool size_mismatch;      // El header no coincide con el tamaño real
+    GBDumpError error;
+    uint32_t error_offset;   // Offset donde se detectó el fallo
+    uint16_t pauses;         // Veces que se pausó por mal contacto
+} GBDumpResult;
+
+// Resultado de una verificación
+typedef struct {
+    uint32_t file_size;         // Bytes del archivo (= bytes a comparar)
+    uint32_t cart_size;         // Tamaño de la ROM detectado en el cartucho
+    bool size_mismatch;         // El archivo no mide lo mismo que la ROM
+    uint32_t bytes_compared;
+    uint32_t chunks_compared;
+    bool sampled;               // Sólo se compararon bloques al azar
+    bool match;                 // Todo lo comparado coincide
+    uint32_t mismatch_offset;   // Primer byte distinto
+    uint8_t cart_value;         // Valor en el cartucho en ese offset
+    uint8_t file_value;         // Valor en el archivo en ese offset
+    GBDumpError error;
+} GBVerifyResult;
+
+// Funciones de volcado
+bool gb_dump_rom(
+    GBMapper* mapper,
+    const GBCartInfo* info,
+    const char* path,
+    GBDumpFormat format,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBDumpResult* result);
+bool gb_dump_save(
+    GBMapper* mapper,
+    const char* path,
+    GBDumpFormat format,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBDumpResult* result);
+bool gb_dump_gba_rom(
+    const char* path,
+    GBDumpFormat format,
+    uint32_t size,
+    GBDumpDataCallback data_callback,
+    void* data_context,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBDumpResult* result);
+bool gb_dump_verify_rom(
+    GBMapper* mapper,
+    const char* path,
+    bool sampled,
+    GBDumpProgressCallback callback,
+    void* context,
+    GBVerifyResult* result);
+const char* gb_dump_get_error_string(GBDumpError error);
+
+#endif // GB_DUMP_H
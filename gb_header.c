@@ -0,0 +1,165 @@
+#include "gb_header.h"
+#include <string.h>
+
+// Logo de Nintendo (0x104-0x133), igual en todos los cartuchos
+static const uint8_t gb_cart_logo[GB_CART_LOGO_SIZE] = {
+    0xCE, 0xED, 0x66, 0x66, 0xCC, 0x0D, 0x00, 0x0B, 0x03, 0x73, 0x00, 0x83,
+    0x00, 0x0C, 0x00, 0x0D, 0x00, 0x08, 0x11, 0x1F, 0x88, 0x89, 0x00, 0x0E,
+    0xDC, 0xCC, 0x6E, 0xE6, 0xDD, 0xDD, 0xD9, 0x99, 0xBB, 0xBB, 0x67, 0x63,
+    0x6E, 0x0E, 0xEC, 0xCC, 0xDD, 0xDC, 0x99, 0x9F, 0xBB, 0xB9, 0x33, 0x3E,
+};
+
+// Parsea el header (0x100-0x14F) desde un buffer con el principio de la ROM.
+// Limpia el título, decodifica los tamaños y calcula los checksums
+bool gb_cart_parse_header(const uint8_t* buffer, size_t length, GBCartInfo* info) {
+    if (!buffer || !info || length < GB_CART_HEADER_END) return false;
+    
+    memset(info, 0, sizeof(GBCartInfo));
+    
+    // Leer el título del cartucho (0x0134 - 0x0143)
+    uint8_t titleLength = 0;
+    for (uint16_t titleAddress = 0x0134; titleAddress <= 0x0143; titleAddress++) {
+        char headerChar = buffer[titleAddress];
+
+        if ((headerChar >= 0x30 && headerChar <= 0x39) || // 0-9
+            (headerChar >= 0x41 && headerChar <= 0x5A) || // A-Z
+            (headerChar >= 0x61 && headerChar <= 0x7A) || // a-z
+            (headerChar >= 0x24 && headerChar <= 0x29) || // #$%&'()
+            (headerChar == 0x2D) ||                       // -
+            (headerChar == 0x2E) ||                       // .
+            (headerChar == 0x5F) ||                       // _
+            (headerChar == 0x20)) {                       // Space
+            info->title[titleAddress - 0x0134] = headerChar;
+            titleLength++;
+        }
+        // Reemplazar con guión bajo
+        else if (headerChar == 0x3A) {
+            info->title[titleAddress - 0x0134] = '_';
+            titleLength++;
+        }
+        else {
+            info->title[titleAddress - 0x0134] = '\0';
+            break;
+        }
+    }
+    
+    // Leer el tipo de cartucho (offset 0x147)
+    info->cart_type = buffer[0x147];
+    
+    // Leer el tamaño de ROM (offset 0x148)
+    uint8_t rom_size_code = buffer[0x148];
+    info->rom_size = (rom_size_code <= 8) ? (32768 << rom_size_code) : 0;  // 32KB * 2^rom_size_code
+    info->rom_banks = info->rom_size / 32768;  // Cada banco es de 32KB
+    
+    // Leer el tamaño de RAM (offset 0x149)
+    uint8_t ram_size_code = buffer[0x149];
+    switch (ram_size_code) {
+        case 0: info->ram_size = 0; break;
+        case 1: info->ram_size = 2048; break;    // 2KB
+        case 2: info->ram_size = 8192; break;    // 8KB
+        case 3: info->ram_size = 32768; break;   // 32KB
+        case 4: info->ram_size = 131072; break;  // 128KB
+        case 5: info->ram_size = 65536; break;   // 64KB
+        default: info->ram_size = 0; break;
+    }
+    info->ram_banks = info->ram_size / 8192;  // Cada banco es de 8KB
+    
+    // Verificar características
+    info->has_battery = (info->cart_type == 0x03 || // MBC1+RAM+BATTERY
+                        info->cart_type == 0x06 || // MBC2+BATTERY
+                        info->cart_type == 0x09 || // ROM+RAM+BATTERY
+                        info->cart_type == 0x0D || // MMM01+RAM+BATTERY
+                        info->cart_type == 0x0F || // MBC3+TIMER+BATTERY
+                        info->cart_type == 0x10 || // MBC3+TIMER+RAM+BATTERY
+                        info->cart_type == 0x13 || // MBC3+RAM+BATTERY
+                        info->cart_type == 0x17 || // MBC4+RAM+BATTERY
+                        info->cart_type == 0x1B || // MBC5+RAM+BATTERY
+                        info->cart_type == 0x1E || // MBC5+RUMBLE+RAM+BATTERY
+                        info->cart_type == 0xFF);  // HuC1+RAM+BATTERY
+    
+    // Verificar SGB (offset 0x146)
+    info->has_sgb = (buffer[0x146] == 0x03);
+    
+    // Calcular checksum
+    uint16_t checksum = 0;
+    for (int i = 0x134; i <= 0x14C; i++) {
+        checksum += buffer[i];
+    }
+    info->checksum = checksum & 0xFF;
+    
+    // Checksum global declarado en el header
+    info->global_checksum = (buffer[0x14E] << 8) | buffer[0x14F];
+    
+    // Checksum del header: x = x - byte - 1 sobre 0x134-0x14C
+    uint8_t header_checksum = 0;
+    for (int i = 0x134; i <= 0x14C; i++) {
+        header_checksum = header_checksum - buffer[i] - 1;
+    }
+    info->header_checksum = buffer[GB_CART_HEADER_CHECKSUM];
+    info->header_checksum_ok = (header_checksum == info->header_checksum);
+    
+    // Game Boy Color (0x80: compatible, 0xC0: sólo GBC) y logo
+    info->is_gbc = (buffer[GB_CART_CGB_FLAG] & 0x80) != 0;
+    info->logo_ok = gb_cart_logo_matches(&buffer[GB_CART_LOGO_START], GB_CART_LOGO_SIZE);
+    
+    return true;
+}
+
+// Checksum global: suma de toda la ROM excepto los dos bytes del propio
+// checksum (0x14E-0x14F)
+uint16_t gb_cart_global_checksum(const uint8_t* rom, size_t length) {
+    uint16_t checksum = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (i != GB_CART_GLOBAL_CHECKSUM && i != GB_CART_GLOBAL_CHECKSUM + 1) {
+            checksum += rom[i];
+        }
+    }
+    return checksum;
+}
+
+// Función para obtener el string del tipo de cartucho
+uint8_t gb_cart_get_type_string(char* buffer, uint8_t type) {
+    switch(type) {
+        case 0x00: strcpy(buffer, "ROM ONLY"); return 8;
+        case 0x01: strcpy(buffer, "MBC1"); return 4;
+        case 0x02: strcpy(buffer, "MBC1+RAM"); return 8;
+        case 0x03: strcpy(buffer, "MBC1+RAM+BATTERY"); return 16;
+        case 0x05: strcpy(buffer, "MBC2"); return 4;
+        case 0x06: strcpy(buffer, "MBC2+BATTERY"); return 12;
+        case 0x08: strcpy(buffer, "ROM+RAM"); return 7;
+        case 0x09: strcpy(buffer, "ROM+RAM+BATTERY"); return 15;
+        case 0x0B: strcpy(buffer, "MMM01"); return 5;
+        case 0x0C: strcpy(buffer, "MMM01+RAM"); return 9;
+        case 0x0D: strcpy(buffer, "MMM01+RAM+BATTERY"); return 17;
+        case 0x0F: strcpy(buffer, "MBC3+TIMER+BATTERY"); return 17;
+        case 0x10: strcpy(buffer, "MBC3+TIMER+RAM+BATTERY"); return 21;
+        case 0x11: strcpy(buffer, "MBC3"); return 4;
+        case 0x12: strcpy(buffer, "MBC3+RAM"); return 8;
+        case 0x13: strcpy(buffer, "MBC3+RAM+BATTERY"); return 16;
+        case 0x15: strcpy(buffer, "MBC4"); return 4;
+        case 0x16: strcpy(buffer, "MBC4+RAM"); return 8;
+        case 0x17: strcpy(buffer, "MBC4+RAM+BATTERY"); return 16;
+        case 0x19: strcpy(buffer, "MBC5"); return 4;
+        case 0x1A: strcpy(buffer, "MBC5+RAM"); return 8;
+        case 0x1B: strcpy(buffer, "MBC5+RAM+BATTERY"); return 16;
+        case 0x1C: strcpy(buffer, "MBC5+RUMBLE"); return 11;
+        case 0x1D: strcpy(buffer, "MBC5+RUMBLE+RAM"); return 15;
+        case 0x1E: strcpy(buffer, "MBC5+RUMBLE+RAM+BATTERY"); return 23;
+        case 0xFC: strcpy(buffer, "POCKET CAMERA"); return 12;
+        case 0xFD: strcpy(buffer, "BANDAI TAMA5"); return 11;
+        case 0xFE: strcpy(buffer, "HuC3"); return 4;
+        case 0xFF: strcpy(buffer, "HuC1+RAM+BATTERY"); return 15;
+        default: strcpy(buffer, "UNKNOWN"); return 7;
+    }
+}
+
+// Compara un buffer leído desde 0x104 con el logo de Nintendo
+bool gb_cart_logo_matches(const uint8_t* buffer, uint8_t length) {
+    if (!buffer || length > GB_CART_LOGO_SIZE) return false;
+    return memcmp(buffer, gb_cart_logo, length) == 0;
+}
+
+// Logo de referencia (GB_CART_LOGO_SIZE bytes) para comparar byte a byte
+const uint8_t* gb_cart_get_logo(void) {
+    return gb_cart_logo;
+}
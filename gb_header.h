@@ -0,0 +1,83 @@
+#ifndef GB_HEADER_H
+#define GB_HEADER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Parser del header de Game Boy sobre un buffer: no toca el bus ni usa furi,
+// así que se compila también en las herramientas del PC (tools/gb_catalog.c)
+
+// Estructura para almacenar la información del cartucho
+typedef struct {
+    char title[17];
+    uint8_t checksum;
+    bool has_sgb;
+    bool is_gbc;
+    char serial[4];
+    uint8_t ram_banks;
+    uint8_t rom_banks;
+    uint8_t cart_type;
+    bool has_battery;
+    uint32_t rom_size;
+    uint32_t ram_size;
+    uint16_t global_checksum;  // 0x14E-0x14F (big endian)
+    uint8_t header_checksum;   // 0x14D
+    bool header_checksum_ok;   // 0x14D coincide con el calculado
+    bool logo_ok;              // Logo de Nintendo correcto
+} GBCartInfo;
+
+// Constantes para el cartucho
+#define GB_CART_TITLE_START 0x134
+#define GB_CART_TITLE_END 0x143
+#define GB_CART_SGB_FLAG 0x146
+#define GB_CART_CART_TYPE 0x147
+#define GB_CART_ROM_SIZE 0x148
+#define GB_CART_RAM_SIZE 0x149
+#define GB_CART_DEST_CODE 0x14A
+#define GB_CART_LICENSE_CODE 0x14B
+#define GB_CART_VERSION 0x14C
+#define GB_CART_CHECKSUM 0x14E
+#define GB_CART_HEADER_CHECKSUM 0x14D
+#define GB_CART_GLOBAL_CHECKSUM 0x14E
+#define GB_CART_LOGO_START 0x104
+#define GB_CART_LOGO_SIZE 48
+#define GB_CART_CGB_FLAG 0x143
+#define GB_CART_HEADER_END 0x150  // Bytes necesarios para parsear el header
+
+// Tipos de cartucho
+#define GB_CART_TYPE_ROM_ONLY 0x00
+#define GB_CART_TYPE_MBC1 0x01
+#define GB_CART_TYPE_MBC1_RAM 0x02
+#define GB_CART_TYPE_MBC1_RAM_BATTERY 0x03
+#define GB_CART_TYPE_MBC2 0x05
+#define GB_CART_TYPE_MBC2_BATTERY 0x06
+#define GB_CART_TYPE_ROM_RAM 0x08
+#define GB_CART_TYPE_ROM_RAM_BATTERY 0x09
+#define GB_CART_TYPE_MMM01 0x0B
+#define GB_CART_TYPE_MMM01_RAM 0x0C
+#define GB_CART_TYPE_MMM01_RAM_BATTERY 0x0D
+#define GB_CART_TYPE_MBC3_TIMER_BATTERY 0x0F
+#define GB_CART_TYPE_MBC3_TIMER_RAM_BATTERY 0x10
+#define GB_CART_TYPE_MBC3 0x11
+#define GB_CART_TYPE_MBC3_RAM 0x12
+#define GB_CART_TYPE_MBC3_RAM_BATTERY 0x13
+#define GB_CART_TYPE_MBC5 0x19
+#define GB_CART_TYPE_MBC5_RAM 0x1A
+#define GB_CART_TYPE_MBC5_RAM_BATTERY 0x1B
+#define GB_CART_TYPE_MBC5_RUMBLE 0x1C
+#define GB_CART_TYPE_MBC5_RUMBLE_RAM 0x1D
+#define GB_CART_TYPE_MBC5_RUMBLE_RAM_BATTERY 0x1E
+#define GB_CART_TYPE_POCKET_CAMERA 0xFC
+#define GB_CART_TYPE_BANDAI_TAMA5 0xFD
+#define GB_CART_TYPE_HUC3 0xFE
+#define GB_CART_TYPE_HUC1_RAM_BATTERY 0xFF
+
+// Funciones del header
+bool gb_cart_parse_header(const uint8_t* buffer, size_t length, GBCartInfo* info);
+uint16_t gb_cart_global_checksum(const uint8_t* rom, size_t length);
+uint8_t gb_cart_get_type_string(char* buffer, uint8_t type);
+bool gb_cart_logo_matches(const uint8_t* buffer, uint8_t length);
+const uint8_t* gb_cart_get_logo(void);
+
+#endif // GB_HEADER_H
@@ -0,0 +1,153 @@
+#include "gb_lz.h"
+#include <string.h>
+
+// Envía el buffer de salida al destino
+static bool gb_lz_flush_out(GBLzEncoder* encoder) {
+    if(encoder->out_length == 0) return !encoder->error;
+    if(!encoder->error && !encoder->write(encoder->out, encoder->out_length, encoder->context)) {
+        encoder->error = true;
+    }
+    encoder->bytes_out += encoder->out_length;
+    encoder->out_length = 0;
+    return !encoder->error;
+}
+
+static void gb_lz_emit(GBLzEncoder* encoder, const uint8_t* data, size_t length) {
+    while(length > 0) {
+        size_t space = GB_LZ_OUT_BUFFER_SIZE - encoder->out_length;
+        size_t chunk = length < space ? length : space;
+        memcpy(&encoder->out[encoder->out_length], data, chunk);
+        encoder->out_length += chunk;
+        data += chunk;
+        length -= chunk;
+        if(encoder->out_length == GB_LZ_OUT_BUFFER_SIZE) gb_lz_flush_out(encoder);
+    }
+}
+
+// Cierra el grupo actual (flags + elementos)
+static void gb_lz_flush_group(GBLzEncoder* encoder) {
+    if(encoder->group_items == 0) return;
+    gb_lz_emit(encoder, encoder->group, encoder->group_length);
+    encoder->group[0] = 0;
+    encoder->group_length = 1;
+    encoder->group_items = 0;
+}
+
+static void gb_lz_put_literal(GBLzEncoder* encoder, uint8_t value) {
+    encoder->group[0] |= 1 << encoder->group_items;
+    encoder->group[encoder->group_length++] = value;
+    if(++encoder->group_items == 8) gb_lz_flush_group(encoder);
+}
+
+static void gb_lz_put_match(GBLzEncoder* encoder, uint16_t distance, uint16_t length) {
+    uint16_t code = (length >= GB_LZ_LONG_MATCH) ? GB_LZ_LONG_CODE : length - GB_LZ_MIN_MATCH;
+    uint16_t token = (uint16_t)((distance - 1) | (code << GB_LZ_WINDOW_BITS));
+    encoder->group[encoder->group_length++] = token & 0xFF;
+    encoder->group[encoder->group_length++] = token >> 8;
+    if(code == GB_LZ_LONG_CODE) {
+        encoder->group[encoder->group_length++] = length - GB_LZ_LONG_MATCH;
+    }
+    if(++encoder->group_items == 8) gb_lz_flush_group(encoder);
+}
+
+static uint16_t gb_lz_hash(const uint8_t* data) {
+    return ((data[0] << 5) ^ (data[1] << 2) ^ data[2] ^ (data[0] >> 3)) & (GB_LZ_HASH_SIZE - 1);
+}
+
+// Añade un byte a la ventana; si hay 3 bytes disponibles también al hash
+static void gb_lz_insert(GBLzEncoder* encoder, const uint8_t* data, size_t available) {
+    uint16_t slot = encoder->position & GB_LZ_WINDOW_MASK;
+    if(available >= GB_LZ_MIN_MATCH) {
+        uint16_t hash = gb_lz_hash(data);
+        encoder->prev[slot] = encoder->head[hash];
+        encoder->head[hash] = (uint16_t)encoder->position;
+    }
+    encoder->window[slot] = data[0];
+    encoder->position++;
+}
+
+// Busca la copia más larga para data[0..available) en la ventana
+static uint16_t gb_lz_find_match(GBLzEncoder* encoder, const uint8_t* data, size_t available, uint16_t* best_distance) {
+    uint16_t max_length = available < GB_LZ_MAX_MATCH ? available : GB_LZ_MAX_MATCH;
+    uint16_t best_length = 0;
+    uint16_t candidate = encoder->head[gb_lz_hash(data)];
+    uint16_t last_distance = 0;
+
+    for(uint8_t chain = 0; chain < GB_LZ_MAX_CHAIN; chain++) {
+        uint16_t distance = (uint16_t)encoder->position - candidate;
+        // Las posiciones guardadas son de 16 bits: se descartan las que salen
+        // de la ventana o que no avanzan hacia atrás (cadena reescrita)
+        if(distance == 0 || distance > GB_LZ_WINDOW_SIZE || distance > encoder->position ||
+           distance <= last_distance) {
+            break;
+        }
+        last_distance = distance;
+
+        uint16_t length = 0;
+        while(length < max_length) {
+            uint8_t source = (length < distance) ?
+                                 encoder->window[(encoder->position - distance + length) & GB_LZ_WINDOW_MASK] :
+                                 data[length - distance];
+            if(source != data[length]) break;
+            length++;
+        }
+
+        if(length > best_length) {
+            best_length = length;
+            *best_distance = distance;
+            if(length == max_length) break;
+        }
+
+        candidate = encoder->prev[candidate & GB_LZ_WINDOW_MASK];
+    }
+
+    return best_length;
+}
+
+void gb_lz_encoder_init(GBLzEncoder* encoder, GBLzWriteCallback write, void* context) {
+    memset(encoder, 0, sizeof(GBLzEncoder));
+    encoder->write = write;
+    encoder->context = context;
+    encoder->group_length = 1;
+    gb_lz_emit(encoder, (const uint8_t*)GB_LZ_MAGIC, GB_LZ_MAGIC_SIZE);
+}
+
+// Comprime un bloque de entrada. Las copias no cruzan el final del bloque,
+// así que el estado que se mantiene entre bloques es sólo la ventana
+bool gb_lz_encoder_write(GBLzEncoder* encoder, const uint8_t* data, size_t length) {
+    size_t index = 0;
+    while(index < length) {
+        size_t available = length - index;
+        uint16_t distance = 0;
+        uint16_t match = 0;
+        if(available >= GB_LZ_MIN_MATCH) {
+            match = gb_lz_find_match(encoder, &data[index], available, &distance);
+        }
+
+        if(match >= GB_LZ_MIN_MATCH) {
+            gb_lz_put_match(encoder, distance, match);
+            for(uint16_t i = 0; i < match; i++) {
+                gb_lz_insert(encoder, &data[index + i], available - i);
+            }
+            index += match;
+        } else {
+            gb_lz_put_literal(encoder, data[index]);
+            gb_lz_insert(encoder, &data[index], available);
+            index++;
+        }
+    }
+    return !encoder->error;
+}
+
+// Cierra el flujo: último grupo y tamaño original
+bool gb_lz_encoder_finish(GBLzEncoder* encoder) {
+    gb_lz_flush_group(encoder);
+    uint8_t footer[GB_LZ_FOOTER_SIZE] = {
+        encoder->position & 0xFF,
+        (encoder->position >> 8) & 0xFF,
+        (encoder->position >> 16) & 0xFF,
+        (encoder->position >> 24) & 0xFF,
+    };
+    gb_lz_emit(encoder, footer, sizeof(footer));
+    return gb_lz_flush_out(encoder);
+}
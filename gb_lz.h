@@ -0,0 +1,56 @@
+#ifndef GB_LZ_H
+#define GB_LZ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Formato GBZ: compresor LZ de ventana pequeña pensado para volcados.
+//
+//  "GBZ1" | grupos | tamaño original (uint32 little endian)
+//
+// Cada grupo empieza con un byte de flags (bit 0 primero) seguido de hasta
+// 8 elementos: flag 1 = literal (1 byte), flag 0 = copia (2 bytes LE):
+//  bits 0-9   distancia - 1 (1..1024)
+//  bits 10-15 longitud - 3 (3..65); 63 indica un byte extra con longitud - 66
+//
+// No depende de furi para poder compilar el descompresor en el PC.
+
+#define GB_LZ_MAGIC           "GBZ1"
+#define GB_LZ_MAGIC_SIZE      4
+#define GB_LZ_FOOTER_SIZE     4
+#define GB_LZ_WINDOW_BITS     10
+#define GB_LZ_WINDOW_SIZE     (1 << GB_LZ_WINDOW_BITS)
+#define GB_LZ_WINDOW_MASK     (GB_LZ_WINDOW_SIZE - 1)
+#define GB_LZ_HASH_SIZE       1024
+#define GB_LZ_MAX_CHAIN       16
+#define GB_LZ_MIN_MATCH       3
+#define GB_LZ_LONG_CODE       63
+#define GB_LZ_LONG_MATCH      66
+#define GB_LZ_MAX_MATCH       (GB_LZ_LONG_MATCH + 255)
+#define GB_LZ_OUT_BUFFER_SIZE 512
+
+// Destino de los bytes comprimidos (normalmente un archivo en la SD)
+typedef bool (*GBLzWriteCallback)(const uint8_t* data, size_t length, void* context);
+
+typedef struct {
+    uint8_t window[GB_LZ_WINDOW_SIZE];  // Últimos bytes vistos
+    uint16_t head[GB_LZ_HASH_SIZE];     // Última posición por hash de 3 bytes
+    uint16_t prev[GB_LZ_WINDOW_SIZE];   // Cadena de posiciones anteriores
+    uint32_t position;                  // Bytes de entrada procesados
+    uint8_t group[1 + 8 * 3];           // Grupo en construcción
+    uint8_t group_length;
+    uint8_t group_items;
+    uint8_t out[GB_LZ_OUT_BUFFER_SIZE];
+    size_t out_length;
+    uint32_t bytes_out;                 // Bytes comprimidos emitidos
+    bool error;
+    GBLzWriteCallback write;
+    void* context;
+} GBLzEncoder;
+
+void gb_lz_encoder_init(GBLzEncoder* encoder, GBLzWriteCallback write, void* context);
+bool gb_lz_encoder_write(GBLzEncoder* encoder, const uint8_t* data, size_t length);
+bool gb_lz_encoder_finish(GBLzEncoder* encoder);
+
+#endif // GB_LZ_H
@@ -0,0 +1,306 @@
+#include "gb_mapper.h"
+#include <string.h>
+
+// Direcciones de escritura de los registros del MBC
+#define GB_MAPPER_ADDR_RAM_ENABLE    0x0000
+#define GB_MAPPER_ADDR_ROM_BANK_LOW  0x2000
+#define GB_MAPPER_ADDR_ROM_BANK_HIGH 0x3000
+#define GB_MAPPER_ADDR_BANK2         0x4000
+#define GB_MAPPER_ADDR_MODE          0x6000
+#define GB_MAPPER_ADDR_MBC2_ROM_BANK 0x2100  // MBC2 usa A8 para distinguir registros
+
+#define GB_MAPPER_RAM_ENABLE_VALUE   0x0A
+#define GB_MAPPER_RAM_DISABLE_VALUE  0x00
+#define GB_MAPPER_MBC2_RAM_SIZE      512
+
+// Obtiene la familia de mapper a partir del byte 0x147 del header
+GBMapperType gb_mapper_type_from_cart(uint8_t cart_type) {
+    switch(cart_type) {
+        case GB_CART_TYPE_ROM_ONLY:
+        case GB_CART_TYPE_ROM_RAM:
+        case GB_CART_TYPE_ROM_RAM_BATTERY:
+            return GB_MAPPER_ROM_ONLY;
+        case GB_CART_TYPE_MBC1:
+        case GB_CART_TYPE_MBC1_RAM:
+        case GB_CART_TYPE_MBC1_RAM_BATTERY:
+            return GB_MAPPER_MBC1;
+        case GB_CART_TYPE_MBC2:
+        case GB_CART_TYPE_MBC2_BATTERY:
+            return GB_MAPPER_MBC2;
+        case GB_CART_TYPE_MBC3_TIMER_BATTERY:
+        case GB_CART_TYPE_MBC3_TIMER_RAM_BATTERY:
+        case GB_CART_TYPE_MBC3:
+        case GB_CART_TYPE_MBC3_RAM:
+        case GB_CART_TYPE_MBC3_RAM_BATTERY:
+            return GB_MAPPER_MBC3;
+        case GB_CART_TYPE_MBC5:
+        case GB_CART_TYPE_MBC5_RAM:
+        case GB_CART_TYPE_MBC5_RAM_BATTERY:
+        case GB_CART_TYPE_MBC5_RUMBLE:
+        case GB_CART_TYPE_MBC5_RUMBLE_RAM:
+        case GB_CART_TYPE_MBC5_RUMBLE_RAM_BATTERY:
+            return GB_MAPPER_MBC5;
+        case GB_CART_TYPE_POCKET_CAMERA:
+            return GB_MAPPER_POCKET_CAMERA;
+        case GB_CART_TYPE_HUC3:
+            return GB_MAPPER_HUC3;
+        case GB_CART_TYPE_HUC1_RAM_BATTERY:
+            return GB_MAPPER_HUC1;
+        default:
+            return GB_MAPPER_UNKNOWN;
+    }
+}
+
+// Nombre corto del mapper para mostrar en pantalla
+const char* gb_mapper_get_name(GBMapperType type) {
+    switch(type) {
+        case GB_MAPPER_ROM_ONLY: return "ROM";
+        case GB_MAPPER_MBC1: return "MBC1";
+        case GB_MAPPER_MBC2: return "MBC2";
+        case GB_MAPPER_MBC3: return "MBC3";
+        case GB_MAPPER_MBC5: return "MBC5";
+        case GB_MAPPER_HUC1: return "HuC1";
+        case GB_MAPPER_HUC3: return "HuC3";
+        case GB_MAPPER_POCKET_CAMERA: return "CAMERA";
+        default: return "UNKNOWN";
+    }
+}
+
+// Tamaño máximo de ROM direccionable por cada mapper
+uint32_t gb_mapper_max_rom_size(GBMapperType type) {
+    switch(type) {
+        case GB_MAPPER_MBC1: return 128 * GB_MAPPER_ROM_BANK_SIZE;  // 2MB
+        case GB_MAPPER_MBC2: return 16 * GB_MAPPER_ROM_BANK_SIZE;   // 256KB
+        case GB_MAPPER_MBC3: return 128 * GB_MAPPER_ROM_BANK_SIZE;  // 2MB
+        case GB_MAPPER_MBC5: return 512 * GB_MAPPER_ROM_BANK_SIZE;  // 8MB
+        case GB_MAPPER_HUC1: return 64 * GB_MAPPER_ROM_BANK_SIZE;   // 1MB
+        case GB_MAPPER_HUC3: return 128 * GB_MAPPER_ROM_BANK_SIZE;  // 2MB
+        case GB_MAPPER_POCKET_CAMERA: return 64 * GB_MAPPER_ROM_BANK_SIZE; // 1MB
+        default: return 2 * GB_MAPPER_ROM_BANK_SIZE;                // 32KB
+    }
+}
+
+// Olvida el estado conocido de los registros (p.ej. tras cambiar de cartucho)
+void gb_mapper_invalidate(GBMapper* mapper) {
+    if(!mapper) return;
+    mapper->valid = 0;
+    memset(mapper->regs, 0, sizeof(mapper->regs));
+}
+
+// Inicializa el mapper a partir de la información del header
+bool gb_mapper_init(GBMapper* mapper, const GBCartInfo* info) {
+    if(!mapper || !info) return false;
+
+    memset(mapper, 0, sizeof(GBMapper));
+    mapper->type = gb_mapper_type_from_cart(info->cart_type);
+    mapper->rom_size = info->rom_size;
+    mapper->ram_size = info->ram_size;
+
+    // MBC2 lleva 512x4 bits de RAM interna que el header declara como 0
+    if(mapper->type == GB_MAPPER_MBC2) {
+        mapper->ram_size = GB_MAPPER_MBC2_RAM_SIZE;
+    }
+
+    if(mapper->type == GB_MAPPER_UNKNOWN) {
+        FURI_LOG_W("GB_MAPPER", "Mapper no soportado: 0x%02X", info->cart_type);
+        return false;
+    }
+
+    FURI_LOG_I("GB_MAPPER", "Mapper: %s", gb_mapper_get_name(mapper->type));
+    return true;
+}
+
+// Escribe un registro del MBC sólo si su valor cambia
+static void gb_mapper_write_reg(GBMapper* mapper, GBMapperReg reg, uint16_t address, uint8_t value) {
+    uint8_t reg_bit = 1 << reg;
+    if((mapper->valid & reg_bit) && mapper->regs[reg] == value) {
+        mapper->writes_skipped++;
+        return;
+    }
+
+    gb_cart_write_byte(address, value);
+    mapper->regs[reg] = value;
+    mapper->valid |= reg_bit;
+    mapper->writes_issued++;
+}
+
+// Selecciona un banco de ROM y devuelve la dirección base donde queda visible
+static bool gb_mapper_select_rom_bank(GBMapper* mapper, uint16_t bank, uint16_t* base) {
+    // El banco 0 siempre está en 0x0000 (salvo MBC1 en modo 1, ver abajo)
+    if(bank == 0) {
+        if(mapper->type == GB_MAPPER_MBC1) {
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_MODE, GB_MAPPER_ADDR_MODE, 0);
+        }
+        *base = 0x0000;
+        return true;
+    }
+
+    *base = 0x4000;
+    switch(mapper->type) {
+        case GB_MAPPER_ROM_ONLY:
+            return bank == 1;
+        case GB_MAPPER_MBC1:
+            // Los bancos 0x20/0x40/0x60 no son accesibles en 0x4000: en modo 1
+            // aparecen en 0x0000 usando sólo los bits altos
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_BANK2, GB_MAPPER_ADDR_BANK2, (bank >> 5) & 0x03);
+            if((bank & 0x1F) == 0) {
+                gb_mapper_write_reg(mapper, GB_MAPPER_REG_MODE, GB_MAPPER_ADDR_MODE, 1);
+                *base = 0x0000;
+            } else {
+                gb_mapper_write_reg(mapper, GB_MAPPER_REG_ROM_BANK_LOW, GB_MAPPER_ADDR_ROM_BANK_LOW, bank & 0x1F);
+            }
+            return true;
+        case GB_MAPPER_MBC2:
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_ROM_BANK_LOW, GB_MAPPER_ADDR_MBC2_ROM_BANK, bank & 0x0F);
+            return true;
+        case GB_MAPPER_MBC3:
+        case GB_MAPPER_HUC3:
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_ROM_BANK_LOW, GB_MAPPER_ADDR_ROM_BANK_LOW, bank & 0x7F);
+            return true;
+        case GB_MAPPER_MBC5:
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_ROM_BANK_LOW, GB_MAPPER_ADDR_ROM_BANK_LOW, bank & 0xFF);
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_ROM_BANK_HIGH, GB_MAPPER_ADDR_ROM_BANK_HIGH, (bank >> 8) & 0x01);
+            return true;
+        case GB_MAPPER_HUC1:
+        case GB_MAPPER_POCKET_CAMERA:
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_ROM_BANK_LOW, GB_MAPPER_ADDR_ROM_BANK_LOW, bank & 0x3F);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Habilita la RAM y selecciona un banco, devuelve la dirección base
+static bool gb_mapper_select_ram_bank(GBMapper* mapper, uint8_t bank, uint16_t* base) {
+    *base = GB_MAPPER_RAM_BASE;
+
+    switch(mapper->type) {
+        case GB_MAPPER_ROM_ONLY:
+            // ROM+RAM no tiene registros: sólo hay un banco
+            return bank == 0;
+        case GB_MAPPER_MBC1:
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_RAM_ENABLE, GB_MAPPER_ADDR_RAM_ENABLE, GB_MAPPER_RAM_ENABLE_VALUE);
+            if(bank == 0) {
+                gb_mapper_write_reg(mapper, GB_MAPPER_REG_MODE, GB_MAPPER_ADDR_MODE, 0);
+            } else {
+                gb_mapper_write_reg(mapper, GB_MAPPER_REG_BANK2, GB_MAPPER_ADDR_BANK2, bank & 0x03);
+                gb_mapper_write_reg(mapper, GB_MAPPER_REG_MODE, GB_MAPPER_ADDR_MODE, 1);
+            }
+            return true;
+        case GB_MAPPER_MBC2:
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_RAM_ENABLE, GB_MAPPER_ADDR_RAM_ENABLE, GB_MAPPER_RAM_ENABLE_VALUE);
+            return bank == 0;
+        case GB_MAPPER_MBC3:
+        case GB_MAPPER_MBC5:
+        case GB_MAPPER_HUC1:
+        case GB_MAPPER_HUC3:
+        case GB_MAPPER_POCKET_CAMERA:
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_RAM_ENABLE, GB_MAPPER_ADDR_RAM_ENABLE, GB_MAPPER_RAM_ENABLE_VALUE);
+            gb_mapper_write_reg(mapper, GB_MAPPER_REG_BANK2, GB_MAPPER_ADDR_BANK2, bank & 0x0F);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Lee un rango lineal de la ROM, cambiando de banco sólo cuando hace falta
+bool gb_mapper_read_rom(GBMapper* mapper, uint32_t offset, uint8_t* buffer, size_t length) {
+    if(!mapper || !buffer) return false;
+    if(offset + length > gb_mapper_max_rom_size(mapper->type)) return false;
+
+    while(length > 0) {
+        uint16_t bank = offset / GB_MAPPER_ROM_BANK_SIZE;
+        uint16_t bank_offset = offset % GB_MAPPER_ROM_BANK_SIZE;
+        size_t chunk = GB_MAPPER_ROM_BANK_SIZE - bank_offset;
+        if(chunk > length) chunk = length;
+
+        uint16_t base;
+        if(!gb_mapper_select_rom_bank(mapper, bank, &base)) return false;
+        if(!gb_cart_read_bytes(base + bank_offset, buffer, chunk)) return false;
+
+        offset += chunk;
+        buffer += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+// Lee un rango lineal de la RAM del cartucho
+bool gb_mapper_read_ram(GBMapper* mapper, uint32_t offset, uint8_t* buffer, size_t length) {
+    if(!mapper || !buffer) return false;
+    if(offset + length > mapper->ram_size) return false;
+
+    while(length > 0) {
+        uint8_t bank = offset / GB_MAPPER_RAM_BANK_SIZE;
+        uint16_t bank_offset = offset % GB_MAPPER_RAM_BANK_SIZE;
+        size_t chunk = GB_MAPPER_RAM_BANK_SIZE - bank_offset;
+        if(chunk > length) chunk = length;
+
+        uint16_t base;
+        if(!gb_mapper_select_ram_bank(mapper, bank, &base)) return false;
+        if(!gb_cart_read_bytes(base + bank_offset, buffer, chunk)) return false;
+
+        offset += chunk;
+        buffer += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+// Deshabilita la RAM al terminar para proteger la partida guardada
+void gb_mapper_disable_ram(GBMapper* mapper) {
+    if(!mapper || mapper->type == GB_MAPPER_ROM_ONLY || mapper->type == GB_MAPPER_UNKNOWN) return;
+    gb_mapper_write_reg(mapper, GB_MAPPER_REG_RAM_ENABLE, GB_MAPPER_ADDR_RAM_ENABLE, GB_MAPPER_RAM_DISABLE_VALUE);
+}
+
+// Calcula una huella (FNV-1a) de unos pocos bytes repartidos por un banco
+static bool gb_mapper_bank_fingerprint(GBMapper* mapper, uint16_t bank, uint32_t* fingerprint) {
+    static const uint16_t sample_offsets[GB_MAPPER_PROBE_SAMPLES] = {0x0100, 0x1000, 0x2A00, 0x3FF0};
+    uint8_t sample[GB_MAPPER_PROBE_SAMPLE_LEN];
+    uint32_t hash = 0x811C9DC5;
+
+    for(uint8_t i = 0; i < GB_MAPPER_PROBE_SAMPLES; i++) {
+        uint32_t offset = (uint32_t)bank * GB_MAPPER_ROM_BANK_SIZE + sample_offsets[i];
+        if(!gb_mapper_read_rom(mapper, offset, sample, sizeof(sample))) return false;
+        for(uint8_t j = 0; j < sizeof(sample); j++) {
+            hash = (hash ^ sample[j]) * 0x01000193;
+        }
+    }
+
+    *fingerprint = hash;
+    return true;
+}
+
+// Detecta el tamaño real de la ROM buscando dónde empiezan a repetirse los bancos.
+// Si la ROM tiene N bancos, el MBC ignora los bits altos y el banco N vuelve a
+// mostrar el banco 0 (y N+1 el banco 1)
+bool gb_mapper_detect_rom_size(GBMapper* mapper, uint32_t* detected_size) {
+    if(!mapper || !detected_size) return false;
+
+    uint32_t max_banks = gb_mapper_max_rom_size(mapper->type) / GB_MAPPER_ROM_BANK_SIZE;
+    if(max_banks <= 2) {
+        *detected_size = max_banks * GB_MAPPER_ROM_BANK_SIZE;
+        return true;
+    }
+
+    uint32_t bank0_print, bank1_print;
+    if(!gb_mapper_bank_fingerprint(mapper, 0, &bank0_print)) return false;
+    if(!gb_mapper_bank_fingerprint(mapper, 1, &bank1_print)) return false;
+
+    uint32_t banks = 2;
+    while(banks < max_banks) {
+        uint32_t mirror0_print, mirror1_print;
+        if(!gb_mapper_bank_fingerprint(mapper, banks, &mirror0_print)) return false;
+        if(mirror0_print == bank0_print) {
+            if(!gb_mapper_bank_fingerprint(mapper, banks + 1, &mirror1_print)) return false;
+            if(mirror1_print == bank1_print) break;
+        }
+        banks *= 2;
+    }
+
+    *detected_size = banks * GB_MAPPER_ROM_BANK_SIZE;
+    FURI_LOG_I("GB_MAPPER", "Tamaño detectado: %luKB", *detected_size / 1024);
+    return true;
+}
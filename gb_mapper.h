@@ -0,0 +1,64 @@
+#ifndef GB_MAPPER_H
+#define GB_MAPPER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "gb_cart.h"
+
+// Tamaños de banco del Game Boy
+#define GB_MAPPER_ROM_BANK_SIZE 0x4000
+#define GB_MAPPER_RAM_BANK_SIZE 0x2000
+#define GB_MAPPER_RAM_BASE      0xA000
+
+// Huella de banco usada para detectar el tamaño real de la ROM
+#define GB_MAPPER_PROBE_SAMPLES    4
+#define GB_MAPPER_PROBE_SAMPLE_LEN 8
+
+// Familias de mapper soportadas
+typedef enum {
+    GB_MAPPER_ROM_ONLY = 0,
+    GB_MAPPER_MBC1,
+    GB_MAPPER_MBC2,
+    GB_MAPPER_MBC3,
+    GB_MAPPER_MBC5,
+    GB_MAPPER_HUC1,
+    GB_MAPPER_HUC3,
+    GB_MAPPER_POCKET_CAMERA,
+    GB_MAPPER_UNKNOWN
+} GBMapperType;
+
+// Registros del MBC, indexados por la región en la que se escriben
+typedef enum {
+    GB_MAPPER_REG_RAM_ENABLE = 0, // 0x0000-0x1FFF
+    GB_MAPPER_REG_ROM_BANK_LOW,   // 0x2000-0x2FFF
+    GB_MAPPER_REG_ROM_BANK_HIGH,  // 0x3000-0x3FFF (MBC5)
+    GB_MAPPER_REG_BANK2,          // 0x4000-0x5FFF (banco RAM / bits altos MBC1)
+    GB_MAPPER_REG_MODE,           // 0x6000-0x7FFF (MBC1)
+    GB_MAPPER_REG_COUNT
+} GBMapperReg;
+
+// Estado del mapper: guarda el último valor escrito en cada registro
+// para no repetir cambios de banco que no cambian nada
+typedef struct {
+    GBMapperType type;
+    uint32_t rom_size;
+    uint32_t ram_size;
+    uint8_t regs[GB_MAPPER_REG_COUNT];
+    uint8_t valid;             // Máscara de registros con valor conocido
+    uint32_t writes_issued;    // Escrituras enviadas al cartucho
+    uint32_t writes_skipped;   // Escrituras evitadas gracias a la cache
+} GBMapper;
+
+// Funciones del mapper
+GBMapperType gb_mapper_type_from_cart(uint8_t cart_type);
+const char* gb_mapper_get_name(GBMapperType type);
+uint32_t gb_mapper_max_rom_size(GBMapperType type);
+bool gb_mapper_init(GBMapper* mapper, const GBCartInfo* info);
+void gb_mapper_invalidate(GBMapper* mapper);
+bool gb_mapper_read_rom(GBMapper* mapper, uint32_t offset, uint8_t* buffer, size_t length);
+bool gb_mapper_read_ram(GBMapper* mapper, uint32_t offset, uint8_t* buffer, size_t length);
+void gb_mapper_disable_ram(GBMapper* mapper);
+bool gb_mapper_detect_rom_size(GBMapper* mapper, uint32_t* detected_size);
+
+#endif // GB_MAPPER_H
@@ -0,0 +1,341 @@
+#include "gb_selftest.h"
+#include <stdio.h>
+#include <string.h>
+
+// Nombres de GPA0-GPA7 del MCP2 para los mensajes
+static const char* const gb_selftest_control_names[8] = {
+    "CLK", "WR", "RD", "CS", "AUDIO", "RST", "VOLT", "LED"};
+
+// Clasifica un paseo de unos y ceros sobre las líneas de 'mask'. ones[i] es
+// lo leído con la línea i a 1 y zeros[i] con sólo la línea i a 0; hold[i]
+// son las líneas que además se dejaron a 1 en el patrón de unos (NULL si
+// ninguna). Una línea que siempre se lee igual está atascada; una que falla
+// sólo en algunos patrones está en corto con otra (las dos aparecen en
+// 'bridged')
+static void gb_selftest_classify(
+    const uint16_t* ones,
+    const uint16_t* zeros,
+    const uint8_t* hold,
+    uint8_t width,
+    uint16_t mask,
+    uint16_t* stuck_high,
+    uint16_t* stuck_low,
+    uint16_t* bridged) {
+    uint16_t always_high = mask;
+    uint16_t always_low = mask;
+    uint16_t wrong = 0;
+    for(uint8_t i = 0; i < width; i++) {
+        uint16_t bit = 1 << i;
+        if(!(mask & bit)) continue;
+        uint16_t one = bit | (hold ? hold[i] : 0);
+        always_high &= ones[i] & zeros[i];
+        always_low &= ~ones[i] & ~zeros[i];
+        wrong |= ((ones[i] ^ one) | (zeros[i] ^ (mask & ~bit))) & mask;
+    }
+    *stuck_high = always_high;
+    *stuck_low = always_low;
+    *bridged = wrong & ~(always_high | always_low);
+}
+
+// A0-A15: se escriben en OLATA/OLATB del MCP1 y se leen en GPIOA/GPIOB, que
+// refleja el nivel real del pin (un corto con masa o con otra línea se ve)
+static bool gb_selftest_walk_address(MCP23S17* mcp1, GBSelfTestResult* result) {
+    uint16_t ones[16];
+    uint16_t zeros[16];
+    uint8_t read[2];
+    for(uint8_t i = 0; i < 16; i++) {
+        uint16_t pattern = 1 << i;
+        if(!mcp23s17_write_ports(mcp1, pattern & 0xFF, pattern >> 8) ||
+           !mcp23s17_read_regs(mcp1, MCP23S17_GPIOA, read, 2)) {
+            return false;
+        }
+        ones[i] = read[0] | (read[1] << 8);
+
+        pattern = ~pattern;
+        if(!mcp23s17_write_ports(mcp1, pattern & 0xFF, pattern >> 8) ||
+           !mcp23s17_read_regs(mcp1, MCP23S17_GPIOA, read, 2)) {
+            return false;
+        }
+        zeros[i] = read[0] | (read[1] << 8);
+    }
+
+    gb_selftest_classify(
+        ones, zeros, NULL, 16, 0xFFFF, &result->address_stuck_high, &result->address_stuck_low, &result->address_bridged);
+    result->address_readback = true;
+    return true;
+}
+
+// Paseo sobre un puerto de 8 bits del MCP2. Las líneas fuera de 'mask'
+// mantienen el valor de 'fixed'; en el patrón de unos de la línea i también
+// quedan a 1 las de hold[i] (NULL si ninguna)
+static bool gb_selftest_walk_port(
+    MCP23S17* mcp,
+    uint8_t olat,
+    uint8_t gpio,
+    uint8_t mask,
+    uint8_t fixed,
+    const uint8_t* hold,
+    uint8_t* stuck_high,
+    uint8_t* stuck_low,
+    uint8_t* bridged) {
+    uint16_t ones[8];
+    uint16_t zeros[8];
+    uint8_t value = 0;
+    for(uint8_t i = 0; i < 8; i++) {
+        uint8_t bit = 1 << i;
+        if(!(mask & bit)) continue;
+
+        uint8_t one = (bit | (hold ? hold[i] : 0)) & mask;
+        if(!mcp23s17_write_reg(mcp, olat, one | (fixed & ~mask)) || !mcp23s17_read_reg(mcp, gpio, &value)) {
+            return false;
+        }
+        ones[i] = value;
+        if(!mcp23s17_write_reg(mcp, olat, (mask & ~bit) | (fixed & ~mask)) ||
+           !mcp23s17_read_reg(mcp, gpio, &value)) {
+            return false;
+        }
+        zeros[i] = value;
+    }
+
+    uint16_t high, low, both;
+    gb_selftest_classify(ones, zeros, hold, 8, mask, &high, &low, &both);
+    *stuck_high = high;
+    *stuck_low = low;
+    *bridged = both;
+    return true;
+}
+
+// Líneas de datos vistas desde el cartucho: el logo tiene cada bit a 0 y a 1
+// en algún byte, así que un bit que nunca cambia está atascado
+static void gb_selftest_classify_logo(const uint8_t* read, GBSelfTestResult* result) {
+    const uint8_t* logo = gb_cart_get_logo();
+    uint8_t read_high = 0;
+    uint8_t read_low = 0;
+    uint8_t wrong = 0;
+    for(size_t i = 0; i < GB_CART_LOGO_SIZE; i++) {
+        read_high |= read[i];
+        read_low |= ~read[i];
+        wrong |= read[i] ^ logo[i];
+    }
+    result->cart_data_stuck_high = wrong & ~read_low;
+    result->cart_data_stuck_low = wrong & ~read_high;
+    result->cart_data_bridged = wrong & ~(result->cart_data_stuck_high | result->cart_data_stuck_low);
+}
+
+static bool gb_selftest_read(uint16_t address, uint8_t* buffer, size_t length, GBSelfTestResult* result) {
+    result->bus_reads += length;
+    return gb_cart_read_bytes(address, buffer, length);
+}
+
+// Lecturas del cartucho. Para cada línea Ak se lee el logo en 0x104 y en
+// 0x104 ^ (1 << k): si las dos ventanas coinciden, Ak no llega al cartucho
+// (atascada o cortada) porque las dos direcciones acaban siendo la misma.
+// A0-A5 caen dentro del logo; A6-A15 fuera, en ROM, VRAM o bus abierto, que
+// no repiten el logo
+static bool gb_selftest_cart(GBSelfTestResult* result) {
+    uint8_t logo[GB_CART_LOGO_SIZE];
+    if(!gb_selftest_read(GB_CART_LOGO_START, logo, sizeof(logo), result)) return false;
+    result->logo_ok = gb_cart_logo_matches(logo, sizeof(logo));
+
+    // Todo igual (0xFF, 0x00): no hay cartucho o el bus de datos está muerto
+    bool constant = true;
+    for(size_t i = 1; i < sizeof(logo); i++) {
+        if(logo[i] != logo[0]) constant = false;
+    }
+    if(constant) return true;
+    result->cart_tested = true;
+
+    if(!result->logo_ok) gb_selftest_classify_logo(logo, result);
+
+    uint8_t window[GB_SELFTEST_ALIAS_BYTES];
+    for(uint8_t k = 0; k < 16; k++) {
+        uint16_t address = GB_CART_LOGO_START ^ (1 << k);
+        if(!gb_selftest_read(address, window, sizeof(window), result)) return false;
+        if(memcmp(window, logo, sizeof(window)) == 0) {
+            result->address_open |= 1 << k;
+        }
+    }
+
+    // Checksum del header: cubre 0x134-0x14D, a los dos lados de A6
+    uint8_t header[GB_CART_HEADER_CHECKSUM + 1 - GB_CART_TITLE_START];
+    if(!gb_selftest_read(GB_CART_TITLE_START, header, sizeof(header), result)) return false;
+    uint8_t checksum = 0;
+    for(size_t i = 0; i < sizeof(header) - 1; i++) {
+        checksum = checksum - header[i] - 1;
+    }
+    result->header_ok = (checksum == header[sizeof(header) - 1]);
+    return true;
+}
+
+// Función para comprobar el bus: paseo de unos y ceros en A0-A15 (sólo con el
+// MCP1, los 74HC595 no se pueden leer), en el puerto de control y en D0-D7, y
+// lecturas del cartucho que aíslan cada línea de dirección. Deja el bus en
+// reposo, la dirección sin cachear y la RAM del cartucho deshabilitada
+bool gb_selftest_run(GBAddressBackend* address, MCP23S17* mcp2, GBSelfTestResult* result) {
+    if(!address || !mcp2 || !result) return false;
+
+    memset(result, 0, sizeof(GBSelfTestResult));
+    uint32_t start = furi_get_tick();
+
+    result->spi_ok = gb_address_is_connected(address) && mcp23s17_is_connected(mcp2);
+    if(!result->spi_ok) {
+        FURI_LOG_E("GB_TEST", "Los MCP23S17 no responden");
+        return false;
+    }
+
+    bool success = true;
+    if(address->type == GB_ADDRESS_MCP23S17) {
+        success = gb_selftest_walk_address(address->device, result);
+    }
+
+    // Dirección aparcada en 0x0000 mientras se mueven las señales: WR a 0
+    // sólo puede escribir el registro de habilitar RAM, que se limpia al final
+    gb_address_invalidate(address);
+    success = success && gb_address_set(address, 0x0000);
+
+    // RST y WR sólo bajan en su propio patrón; RD se queda en alto mientras
+    // se pasea WR para que nunca estén los dos a 0
+    uint8_t control_hold[8];
+    for(uint8_t i = 0; i < 8; i++) {
+        uint8_t bit = 1 << i;
+        control_hold[i] = (GB_SELFTEST_CONTROL_RST | GB_SELFTEST_CONTROL_WR) & ~bit;
+        if(bit == GB_SELFTEST_CONTROL_WR) control_hold[i] |= GB_SELFTEST_CONTROL_RD;
+    }
+
+    uint8_t control_mask = GB_SELFTEST_CONTROL_MASK;
+    if(gb_cart_get_wiring() == GB_CART_WIRING_HYBRID) {
+        control_mask &= ~GB_SELFTEST_CONTROL_NATIVE;
+        result->native_strobes_untested = true;
+    }
+
+    uint8_t control = 0;
+    bool control_known = success && mcp23s17_read_reg(mcp2, MCP23S17_OLATA, &control);
+    success = control_known && gb_selftest_walk_port(
+                             mcp2,
+                             MCP23S17_OLATA,
+                             MCP23S17_GPIOA,
+                             control_mask,
+                             control,
+                             control_hold,
+                             &result->control_stuck_high,
+                             &result->control_stuck_low,
+                             &result->control_bridged);
+    if(control_known) mcp23s17_write_reg(mcp2, MCP23S17_OLATA, control);
+
+    // D0-D7 con RD en alto: el cartucho no conduce y las salidas del MCP2
+    // son lo único en el bus
+    if(success) {
+        gb_cart_set_signal(GB_CART_SIGNAL_RD, 1);
+        success = mcp23s17_write_reg(mcp2, MCP23S17_IODIRB, 0x00) &&
+                  gb_selftest_walk_port(
+                      mcp2,
+                      MCP23S17_OLATB,
+                      MCP23S17_GPIOB,
+                      0xFF,
+                      0x00,
+                      NULL,
+                      &result->data_stuck_high,
+                      &result->data_stuck_low,
+                      &result->data_bridged);
+    }
+    mcp23s17_write_reg(mcp2, MCP23S17_IODIRB, 0xFF);
+
+    gb_address_invalidate(address);
+    success = success && gb_selftest_cart(result);
+
+    // El paseo de WR pudo habilitar la RAM del cartucho
+    gb_cart_write_byte(0x0000, 0x00);
+    gb_address_invalidate(address);
+
+    result->duration_ms = furi_get_tick() - start;
+    FURI_LOG_I(
+        "GB_TEST",
+        "Autotest %s: %u lecturas en %lums",
+        gb_selftest_passed(result) ? "OK" : "con fallos",
+        result->bus_reads,
+        result->duration_ms);
+    return success;
+}
+
+bool gb_selftest_passed(const GBSelfTestResult* result) {
+    return result->spi_ok && !result->address_stuck_high && !result->address_stuck_low &&
+           !result->address_bridged && !result->control_stuck_high && !result->control_stuck_low &&
+           !result->control_bridged && !result->data_stuck_high && !result->data_stuck_low &&
+           !result->data_bridged && !result->address_open && result->logo_ok && result->header_ok;
+}
+
+// Primer bit a 1 de una máscara
+static uint8_t gb_selftest_first_bit(uint16_t mask) {
+    uint8_t bit = 0;
+    while(!(mask & (1 << bit))) bit++;
+    return bit;
+}
+
+// Describe un corto: las dos primeras líneas de la máscara
+static void gb_selftest_describe_bridge(char* buffer, size_t size, const char* prefix, uint16_t mask) {
+    uint8_t first = gb_selftest_first_bit(mask);
+    uint16_t rest = mask & ~(1 << first);
+    if(rest) {
+        snprintf(buffer, size, "%s%d-%s%d en corto", prefix, first, prefix, gb_selftest_first_bit(rest));
+    } else {
+        snprintf(buffer, size, "%s%d inestable", prefix, first);
+    }
+}
+
+// Texto corto con el primer fallo encontrado, para la pantalla
+void gb_selftest_describe(const GBSelfTestResult* result, char* buffer, size_t size) {
+    uint8_t data_high = result->data_stuck_high | result->cart_data_stuck_high;
+    uint8_t data_low = result->data_stuck_low | result->cart_data_stuck_low;
+    uint8_t data_bridged = result->data_bridged | result->cart_data_bridged;
+
+    if(!result->spi_ok) {
+        snprintf(buffer, size, "Test: error SPI");
+    } else if(result->address_stuck_high) {
+        snprintf(buffer, size, "A%d atascada a 1", gb_selftest_first_bit(result->address_stuck_high));
+    } else if(result->address_stuck_low) {
+        snprintf(buffer, size, "A%d atascada a 0", gb_selftest_first_bit(result->address_stuck_low));
+    } else if(result->address_bridged) {
+        gb_selftest_describe_bridge(buffer, size, "A", result->address_bridged);
+    } else if(result->control_stuck_high) {
+        snprintf(
+            buffer,
+            size,
+            "%s atascada a 1",
+            gb_selftest_control_names[gb_selftest_first_bit(result->control_stuck_high)]);
+    } else if(result->control_stuck_low) {
+        snprintf(
+            buffer,
+            size,
+            "%s atascada a 0",
+            gb_selftest_control_names[gb_selftest_first_bit(result->control_stuck_low)]);
+    } else if(result->control_bridged) {
+        uint8_t first = gb_selftest_first_bit(result->control_bridged);
+        uint8_t rest = result->control_bridged & ~(1 << first);
+        snprintf(
+            buffer,
+            size,
+            "%s-%s en corto",
+            gb_selftest_control_names[first],
+            rest ? gb_selftest_control_names[gb_selftest_first_bit(rest)] : "?");
+    } else if(data_high) {
+        snprintf(buffer, size, "D%d atascada a 1", gb_selftest_first_bit(data_high));
+    } else if(data_low) {
+        snprintf(buffer, size, "D%d atascada a 0", gb_selftest_first_bit(data_low));
+    } else if(data_bridged) {
+        gb_selftest_describe_bridge(buffer, size, "D", data_bridged);
+    } else if(result->address_open) {
+        snprintf(buffer, size, "A%d no llega al cart.", gb_selftest_first_bit(result->address_open));
+    } else if(!result->cart_tested && result->native_strobes_untested) {
+        snprintf(buffer, size, "Sin cart.; RD/WR/CS sin probar");
+    } else if(!result->cart_tested) {
+        snprintf(buffer, size, "Lineas OK, sin cartucho");
+    } else if(!result->logo_ok) {
+        snprintf(buffer, size, "Logo incorrecto");
+    } else if(!result->header_ok) {
+        snprintf(buffer, size, "Checksum header mal");
+    } else if(result->native_strobes_untested) {
+        snprintf(buffer, size, "Bus OK; RD/WR/CS sin probar");
+    } else {
+        snprintf(buffer, size, "Bus OK (%u lecturas)", result->bus_reads);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef GB_SELFTEST_H
+#define GB_SELFTEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "gb_cart.h"
+
+// Ventana leída en cada dirección de prueba del logo
+#define GB_SELFTEST_ALIAS_BYTES 4
+
+// Línea del puerto de control que no se mueve durante el test: cambiar la
+// tensión del cartucho a mitad de prueba no es seguro
+#define GB_SELFTEST_CONTROL_MASK 0xBF  // Todo GPA salvo GPA6 (VOLTAGE_SELECT)
+
+// Señales activas en bajo que el paseo de control deja en alto fuera de su
+// propio patrón: RST a 0 reinicia el MBC y WR a 0 con RD a 0 escribe en el
+// cartucho lo que haya en un bus de datos flotante
+#define GB_SELFTEST_CONTROL_WR   (1 << 1)  // GPA1
+#define GB_SELFTEST_CONTROL_RD   (1 << 2)  // GPA2
+#define GB_SELFTEST_CONTROL_RST  (1 << 5)  // GPA5
+
+// Con el cableado híbrido RD, WR y CS van a pines del Flipper: GPA1-GPA3 no
+// llegan al cartucho y no se pasean
+#define GB_SELFTEST_CONTROL_CS      (1 << 3)  // GPA3
+#define GB_SELFTEST_CONTROL_NATIVE  (GB_SELFTEST_CONTROL_WR | GB_SELFTEST_CONTROL_RD | GB_SELFTEST_CONTROL_CS)
+
+// Resultado del autotest. Las máscaras usan un bit por línea: A0-A15,
+// D0-D7 y GPA0-GPA7 del MCP2 (CLK, WR, RD, CS, AUDIO, RST, VOLT, LED)
+typedef struct {
+    bool spi_ok;                 // Los MCP23S17 responden
+    bool address_readback;       // A0-A15 se leyeron de vuelta (sólo con MCP1)
+
+    // Paseo de unos y ceros leído en los pines del MCP
+    uint16_t address_stuck_high;
+    uint16_t address_stuck_low;
+    uint16_t address_bridged;
+    uint8_t control_stuck_high;
+    uint8_t control_stuck_low;
+    uint8_t control_bridged;
+    bool native_strobes_untested;  // Híbrido: RD/WR/CS nativos fuera del paseo
+    uint8_t data_stuck_high;
+    uint8_t data_stuck_low;
+    uint8_t data_bridged;
+
+    // Lecturas del cartucho
+    bool cart_tested;            // Se llegó a leer el cartucho
+    bool logo_ok;                // Logo de Nintendo (0x104-0x133) correcto
+    bool header_ok;              // Checksum del header (0x14D) correcto
+    uint16_t address_open;       // Líneas que no llegan al cartucho (lectura repetida del logo)
+    uint8_t cart_data_stuck_high;  // D0-D7 vistas desde el cartucho (logo)
+    uint8_t cart_data_stuck_low;
+    uint8_t cart_data_bridged;
+
+    uint16_t bus_reads;          // Lecturas hechas al cartucho
+    uint32_t duration_ms;
+} GBSelfTestResult;
+
+// Funciones del autotest
+bool gb_selftest_run(GBAddressBackend* address, MCP23S17* mcp2, GBSelfTestResult* result);
+bool gb_selftest_passed(const GBSelfTestResult* result);
+void gb_selftest_describe(const GBSelfTestResult* result, char* buffer, size_t size);
+
+#endif // GB_SELFTEST_H
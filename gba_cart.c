@@ -0,0 +1,336 @@
+#include "gba_cart.h"
+#include "gb_cart.h"
+#include <string.h>
+
+// # GBA
+//  ## Pines de control en MCP1
+//  (24 Bit Address Bus)
+// ## Pines de control en MCP1 (GPA0-GPA7)
+#define GBA_MCP1_A0_PIN          0  // GPA0: A0
+#define GBA_MCP1_A1_PIN          1  // GPA1: A1
+#define GBA_MCP1_A2_PIN          2  // GPA2: A2
+#define GBA_MCP1_A3_PIN          3  // GPA3: A3
+#define GBA_MCP1_A4_PIN          4  // GPA4: A4
+#define GBA_MCP1_A5_PIN          5  // GPA5: A5
+#define GBA_MCP1_A6_PIN          6  // GPA6: A6
+#define GBA_MCP1_A7_PIN          7  // GPA7: A7
+
+// ## Pines de control en MCP1 (GPB0-GPB7)
+#define GBA_MCP1_A8_PIN          0  // GPB0: A8
+#define GBA_MCP1_A9_PIN          1  // GPB1: A9
+#define GBA_MCP1_A10_PIN         2  // GPB2: A10
+#define GBA_MCP1_A11_PIN         3  // GPB3: A11
+#define GBA_MCP1_A12_PIN         4  // GPB4: A12
+#define GBA_MCP1_A13_PIN         5  // GPB5: A13
+#define GBA_MCP1_A14_PIN         6  // GPB6: A14
+#define GBA_MCP1_A15_PIN         7  // GPB7: A15
+
+// ## Pines de control en MCP2 (GPA0-GPA7)
+#define GBA_MCP2_CLK_PIN          0  // GPA0: CLK
+#define GBA_MCP2_WR_PIN           1  // GPA1: WR
+#define GBA_MCP2_RD_PIN           2  // GPA2: RD
+#define GBA_MCP2_CS_PIN           3  // GPA3: CS
+#define GBA_MCP2_CS2_PIN          5  // GPA5: CS2 (pin 30 del slot, RST en GB)
+#define GBA_MCP2_IRQ_PIN          4  // GPA4: IRQ (pin 31 del slot, AUDIO en GB)
+#define GBA_MCP2_VOLTAGE_PIN      6  // GPA6: VOLTAGE_SELECT
+#define GBA_MCP2_ACTIVITY_PIN     7  // GPA7: ACTIVITY_LED
+
+// ## Pines de datos en MCP2 (GPB0-GPB7)
+#define GBA_MCP2_A16_PIN          0  // GPB0: A16
+#define GBA_MCP2_A17_PIN          1  // GPB1: A17
+#define GBA_MCP2_A18_PIN          2  // GPB2: A18
+#define GBA_MCP2_A19_PIN          3  // GPB3: A19
+#define GBA_MCP2_A20_PIN          4  // GPB4: A20
+#define GBA_MCP2_A21_PIN          5  // GPB5: A21
+#define GBA_MCP2_A22_PIN          6  // GPB6: A22
+#define GBA_MCP2_A23_PIN          7  // GPB7: A23
+
+//  (16 Bit Data Bus)
+// ## Pines de control en MCP1 (GPA0-GPA7)
+#define GBA_MCP1_D0_PIN          0  // GPA0: A0
+#define GBA_MCP1_D1_PIN          1  // GPA1: A1
+#define GBA_MCP1_D2_PIN          2  // GPA2: A2
+#define GBA_MCP1_D3_PIN          3  // GPA3: A3
+#define GBA_MCP1_D4_PIN          4  // GPA4: A4
+#define GBA_MCP1_D5_PIN          5  // GPA5: A5
+#define GBA_MCP1_D6_PIN          6  // GPA6: A6
+#define GBA_MCP1_D7_PIN          7  // GPA7: A7
+
+// ## Pines de control en MCP1 (GPB0-GPB7)
+#define GBA_MCP1_D8_PIN          0  // GPB0: A8
+#define GBA_MCP1_D9_PIN          1  // GPB1: A9
+#define GBA_MCP1_D10_PIN         2  // GPB2: A10
+#define GBA_MCP1_D11_PIN         3  // GPB3: A11
+#define GBA_MCP1_D12_PIN         4  // GPB4: A12
+#define GBA_MCP1_D13_PIN         5  // GPB5: A13
+#define GBA_MCP1_D14_PIN         6  // GPB6: A14
+#define GBA_MCP1_D15_PIN         7  // GPB7: A15
+
+
+// Variables globales para los MCP23S17
+static MCP23S17* mcp1 = NULL;
+static MCP23S17* mcp2 = NULL;
+
+// Última dirección puesta en AD0-AD15 en el bus de CS2
+static uint16_t gba_cart_save_address = 0;
+static bool gba_cart_save_address_valid = false;
+
+// Pone AD0-AD15 (MCP1) como salidas o entradas con una sola trama
+static bool gba_cart_ad_output(bool output) {
+    uint8_t iodir[2] = {output ? 0x00 : 0xFF, output ? 0x00 : 0xFF};
+    return mcp23s17_write_regs(mcp1, MCP23S17_IODIRA, iodir, sizeof(iodir));
+}
+
+// Función para inicializar el lector de GBA
+bool gba_cart_init(MCP23S17* mcp1_instance, MCP23S17* mcp2_instance) {
+    mcp1 = mcp1_instance;
+    mcp2 = mcp2_instance;
+    
+    // AD0-AD15 es bidireccional: un 74HC595 no sirve como MCP1
+    if (!mcp1 || !mcp1->initialized || !mcp2 || !mcp2->initialized) {
+        FURI_LOG_E("GBA_CART", "El cartucho de GBA necesita los dos MCP23S17");
+        return false;
+    }
+    
+    // MCP2: control en GPA, A16-A23 en GPB
+    mcp23s17_port_mode(mcp2, MCP23S17_PORT_A, MCP23S17_PIN_MODE_OUTPUT);
+    mcp23s17_port_mode(mcp2, MCP23S17_PORT_B, MCP23S17_PIN_MODE_OUTPUT);
+    
+    // Los cartuchos de GBA son de 3,3 V: antes de cualquier ciclo de bus
+    if (!gb_cart_set_voltage(GB_CART_VOLTAGE_3V3)) {
+        return false;
+    }
+    
+    // Señales en reposo (activas en bajo)
+    gb_cart_set_signal(GB_CART_SIGNAL_CS, 1);
+    gb_cart_set_signal(GB_CART_SIGNAL_RD, 1);
+    gb_cart_set_signal(GB_CART_SIGNAL_WR, 1);
+    mcp23s17_digital_write(mcp2, GBA_MCP2_CS2_PIN, MCP23S17_PORT_A, 1);  // CS2
+    
+    gba_cart_save_address_valid = false;
+    return gba_cart_ad_output(true);
+}
+
+// Latchea una dirección de palabra en el bus de la ROM: AD0-AD15 y A16-A23
+// con CS alto y flanco de bajada de CS. Deja AD0-AD15 como entradas
+static bool gba_cart_latch(uint32_t word_address) {
+    gb_cart_set_signal(GB_CART_SIGNAL_CS, 1);
+    bool result = gba_cart_ad_output(true);
+    result = mcp23s17_write_ports(mcp1, word_address & 0xFF, (word_address >> 8) & 0xFF) && result;
+    result = mcp23s17_write_reg(mcp2, MCP23S17_OLATB, (word_address >> 16) & 0xFF) && result;
+    gb_cart_set_signal(GB_CART_SIGNAL_CS, 0);
+    return gba_cart_ad_output(false) && result;
+}
+
+// Función para leer la ROM (offset y longitud en bytes, pares). Cada palabra
+// es un pulso de RD y una lectura de GPIOA+GPIOB del MCP1 en una sola trama
+bool gba_cart_read_rom(uint32_t offset, uint8_t* buffer, size_t length) {
+    if (!buffer || (offset & 1) || (length & 1) || offset + length > GBA_CART_MAX_ROM_SIZE) {
+        return false;
+    }
+    
+    bool result = true;
+    uint32_t word_address = offset >> 1;
+    for (size_t i = 0; i < length && result; i += 2, word_address++) {
+        // El contador interno no pasa de un bloque de 128 KB al siguiente
+        if (i == 0 || (word_address & 0xFFFF) == 0) {
+            result = gba_cart_latch(word_address);
+        }
+        gb_cart_set_signal(GB_CART_SIGNAL_RD, 0);
+        result = mcp23s17_read_regs(mcp1, MCP23S17_GPIOA, &buffer[i], 2) && result;
+        gb_cart_set_signal(GB_CART_SIGNAL_RD, 1);
+    }
+    
+    gb_cart_set_signal(GB_CART_SIGNAL_CS, 1);
+    gba_cart_ad_output(true);
+    return result;
+}
+
+// Comprueba si en 'offset' se ve el patrón de bus abierto: cada palabra
+// vale los 16 bits bajos de su propia dirección de palabra (salvo AD0 dentro
+// de la posible ventana de la EEPROM)
+static bool gba_cart_is_open_bus(uint32_t offset) {
+    uint8_t buffer[GBA_CART_OPEN_BUS_WORDS * 2];
+    if (!gba_cart_read_rom(offset, buffer, sizeof(buffer))) return false;
+    
+    uint16_t mask = (offset >= GBA_CART_EEPROM_WINDOW_START) ? 0xFFFE : 0xFFFF;
+    uint16_t word_address = offset >> 1;
+    for (size_t i = 0; i < GBA_CART_OPEN_BUS_WORDS; i++, word_address++) {
+        uint16_t value = buffer[i * 2] | (buffer[i * 2 + 1] << 8);
+        if ((value & mask) != (word_address & mask)) return false;
+    }
+    return true;
+}
+
+// Función para detectar el tamaño real de la ROM. El header de GBA no lo
+// indica; el primer límite potencia de dos con bus abierto en sus dos puntos
+// de prueba es el final de la ROM. Un límite que repite el principio de la
+// ROM (chip más pequeño espejado) también marca el final
+bool gba_cart_detect_rom_size(uint32_t* size) {
+    if (!size) return false;
+    
+    uint8_t start[16];
+    if (!gba_cart_read_rom(0, start, sizeof(start))) return false;
+    
+    for (uint32_t boundary = GBA_CART_MIN_ROM_SIZE; boundary < GBA_CART_MAX_ROM_SIZE; boundary <<= 1) {
+        if (gba_cart_is_open_bus(boundary) &&
+            gba_cart_is_open_bus(boundary + GBA_CART_OPEN_BUS_PROBE_WORD * 2)) {
+            *size = boundary;
+            FURI_LOG_I("GBA_CART", "Bus abierto en 0x%07lX: ROM de %luKB", boundary, boundary / 1024);
+            return true;
+        }
+        
+        uint8_t mirror[sizeof(start)];
+        if (!gba_cart_read_rom(boundary, mirror, sizeof(mirror))) return false;
+        if (memcmp(mirror, start, sizeof(start)) == 0) {
+            *size = boundary;
+            FURI_LOG_I("GBA_CART", "Espejo en 0x%07lX: ROM de %luKB", boundary, boundary / 1024);
+            return true;
+        }
+    }
+    
+    *size = GBA_CART_MAX_ROM_SIZE;
+    return true;
+}
+
+// Comprueba el valor fijo 0x96 y el checksum del header (0xA0-0xBC)
+bool gba_cart_header_valid(const uint8_t* header) {
+    if (header[GBA_CART_FIXED_VALUE] != 0x96) return false;
+    
+    uint8_t checksum = 0;
+    for (size_t i = GBA_CART_TITLE; i < GBA_CART_CHECKSUM; i++) {
+        checksum -= header[i];
+    }
+    checksum -= 0x19;
+    return checksum == header[GBA_CART_CHECKSUM];
+}
+
+// Copia un campo de texto del header quitando el relleno
+static void gba_cart_copy_string(char* dest, const uint8_t* src, size_t length) {
+    memcpy(dest, src, length);
+    dest[length] = '\0';
+    for (size_t i = length; i > 0 && (dest[i - 1] == ' ' || dest[i - 1] == '\0'); i--) {
+        dest[i - 1] = '\0';
+    }
+}
+
+// Función para leer la información del cartucho
+bool gba_cart_read_info(GBACartInfo* info) {
+    if (!info) return false;
+    
+    uint8_t header[GBA_CART_HEADER_SIZE];
+    if (!gba_cart_read_rom(0, header, sizeof(header))) {
+        FURI_LOG_E("GBA_CART", "Error leyendo el header");
+        return false;
+    }
+    if (!gba_cart_header_valid(header)) {
+        FURI_LOG_E("GBA_CART", "Header incorrecto (no hay cartucho?)");
+        return false;
+    }
+    
+    memset(info, 0, sizeof(GBACartInfo));
+    gba_cart_copy_string(info->title, &header[GBA_CART_TITLE], GBA_CART_TITLE_LENGTH);
+    gba_cart_copy_string(info->game_code, &header[GBA_CART_GAME_CODE], 4);
+    gba_cart_copy_string(info->maker_code, &header[GBA_CART_MAKER_CODE], 2);
+    info->version = header[GBA_CART_VERSION];
+    info->checksum = header[GBA_CART_CHECKSUM];
+    if (!gba_cart_detect_rom_size(&info->rom_size)) {
+        // Sin detección se vuelca el espacio completo
+        info->rom_size = GBA_CART_MAX_ROM_SIZE;
+    }
+    
+    FURI_LOG_I("GBA_CART", "Cartucho: %s (%s)", info->title, info->game_code);
+    return true;
+}
+
+// Selecciona la memoria de partida: CS2 bajo, AD0-AD15 como dirección y
+// A16-A23 (datos) como entradas
+void gba_cart_save_begin(void) {
+    gba_cart_ad_output(true);
+    mcp23s17_write_reg(mcp2, MCP23S17_IODIRB, 0xFF);
+    mcp23s17_digital_write(mcp2, GBA_MCP2_CS2_PIN, MCP23S17_PORT_A, 0);  // CS2
+    gba_cart_save_address_valid = false;
+}
+
+void gba_cart_save_end(void) {
+    mcp23s17_digital_write(mcp2, GBA_MCP2_CS2_PIN, MCP23S17_PORT_A, 1);  // CS2
+    mcp23s17_write_reg(mcp2, MCP23S17_IODIRB, 0x00);
+}
+
+static bool gba_cart_save_set_address(uint16_t address) {
+    if (gba_cart_save_address_valid && gba_cart_save_address == address) return true;
+    
+    gba_cart_save_address_valid = mcp23s17_write_ports(mcp1, address & 0xFF, (address >> 8) & 0xFF);
+    gba_cart_save_address = address;
+    return gba_cart_save_address_valid;
+}
+
+// Función para leer un byte de la SRAM/Flash
+bool gba_cart_save_read(uint16_t address, uint8_t* value) {
+    if (!value) return false;
+    
+    bool result = gba_cart_save_set_address(address);
+    gb_cart_set_signal(GB_CART_SIGNAL_RD, 0);
+    result = mcp23s17_read_reg(mcp2, MCP23S17_GPIOB, value) && result;
+    gb_cart_set_signal(GB_CART_SIGNAL_RD, 1);
+    return result;
+}
+
+// Función para escribir un byte en la SRAM/Flash (también comandos de la Flash)
+bool gba_cart_save_write(uint16_t address, uint8_t value) {
+    bool result = gba_cart_save_set_address(address);
+    result = mcp23s17_write_reg(mcp2, MCP23S17_IODIRB, 0x00) && result;
+    result = mcp23s17_write_reg(mcp2, MCP23S17_OLATB, value) && result;
+    gb_cart_set_signal(GB_CART_SIGNAL_WR, 0);
+    gb_cart_set_signal(GB_CART_SIGNAL_WR, 1);
+    return mcp23s17_write_reg(mcp2, MCP23S17_IODIRB, 0xFF) && result;
+}
+
+// Envía bits a la EEPROM: un pulso de WR por bit con el valor en AD0
+bool gba_cart_eeprom_write_bits(const uint8_t* bits, size_t count) {
+    if (!bits) return false;
+    
+    bool result = gba_cart_latch(GBA_CART_EEPROM_WORD_ADDRESS);
+    result = gba_cart_ad_output(true) && result;
+    
+    uint8_t last = 0xFF;
+    for (size_t i = 0; i < count && result; i++) {
+        uint8_t bit = bits[i] & 1;
+        if (bit != last) {
+            result = mcp23s17_write_reg(mcp1, MCP23S17_OLATA, bit);
+            last = bit;
+        }
+        gb_cart_set_signal(GB_CART_SIGNAL_WR, 0);
+        gb_cart_set_signal(GB_CART_SIGNAL_WR, 1);
+    }
+    
+    gb_cart_set_signal(GB_CART_SIGNAL_CS, 1);
+    return result;
+}
+
+// Reinicia la EEPROM tras una petición incompleta (ancho de dirección
+// equivocado): un ciclo de CS sin pulsos de RD ni WR
+bool gba_cart_eeprom_reset(void) {
+    bool result = gba_cart_latch(GBA_CART_EEPROM_WORD_ADDRESS);
+    gb_cart_set_signal(GB_CART_SIGNAL_CS, 1);
+    gba_cart_ad_output(true);
+    return result;
+}
+
+// Recibe bits de la EEPROM: un pulso de RD por bit, el valor está en AD0
+bool gba_cart_eeprom_read_bits(uint8_t* bits, size_t count) {
+    if (!bits) return false;
+    
+    bool result = gba_cart_latch(GBA_CART_EEPROM_WORD_ADDRESS);
+    for (size_t i = 0; i < count && result; i++) {
+        uint8_t value = 0xFF;
+        gb_cart_set_signal(GB_CART_SIGNAL_RD, 0);
+        result = mcp23s17_read_reg(mcp1, MCP23S17_GPIOA, &value);
+        gb_cart_set_signal(GB_CART_SIGNAL_RD, 1);
+        bits[i] = value & 1;
+    }
+    
+    gb_cart_set_signal(GB_CART_SIGNAL_CS, 1);
+    gba_cart_ad_output(true);
+    return result;
+}
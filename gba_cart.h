@@ -0,0 +1,70 @@
+#ifndef GBA_CART_H
+#define GBA_CART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "mcp23s17_api.h"
+
+// Bus de la ROM: 24 bits de dirección de palabra (32 MB) multiplexados con los
+// 16 bits de datos. El contador interno del cartucho sólo incrementa los 16
+// bits bajos, así que las lecturas secuenciales se relatchean cada 128 KB
+#define GBA_CART_MAX_ROM_SIZE   0x2000000
+#define GBA_CART_ROM_BLOCK_SIZE 0x20000
+
+// Detección del tamaño: fuera de la ROM el bus queda abierto y cada lectura
+// devuelve los 16 bits bajos de la dirección de palabra. Se prueban los
+// límites potencia de dos desde el tamaño mínimo, en dos puntos de cada uno
+#define GBA_CART_MIN_ROM_SIZE         0x40000
+#define GBA_CART_OPEN_BUS_WORDS       4
+#define GBA_CART_OPEN_BUS_PROBE_WORD  0x1234  // Segundo punto, dentro del bloque
+
+// En cartuchos de hasta 16 MB con EEPROM toda la mitad alta (A23 a 1) es la
+// ventana de la EEPROM, que conduce AD0 aunque el resto del bus quede
+// abierto: a partir de ese límite AD0 no se tiene en cuenta
+#define GBA_CART_EEPROM_WINDOW_START  0x1000000
+
+// Header del cartucho
+#define GBA_CART_HEADER_SIZE   0xC0
+#define GBA_CART_TITLE         0xA0
+#define GBA_CART_TITLE_LENGTH  12
+#define GBA_CART_GAME_CODE     0xAC
+#define GBA_CART_MAKER_CODE    0xB0
+#define GBA_CART_FIXED_VALUE   0xB2  // Siempre 0x96
+#define GBA_CART_VERSION       0xBC
+#define GBA_CART_CHECKSUM      0xBD  // Complemento de 0xA0-0xBC
+
+// La EEPROM responde en la parte alta del espacio de la ROM (0x0DFFFF00 en
+// la CPU). Esta dirección de palabra vale tanto para ROMs de hasta 16 MB
+// (basta con A23) como para las de 32 MB
+#define GBA_CART_EEPROM_WORD_ADDRESS 0xFFFF80
+
+typedef struct {
+    char title[GBA_CART_TITLE_LENGTH + 1];
+    char game_code[5];
+    char maker_code[3];
+    uint8_t version;
+    uint8_t checksum;
+    uint32_t rom_size;
+} GBACartInfo;
+
+// Funciones del cartucho de GBA
+bool gba_cart_init(MCP23S17* mcp1, MCP23S17* mcp2);
+bool gba_cart_read_rom(uint32_t offset, uint8_t* buffer, size_t length);
+bool gba_cart_read_info(GBACartInfo* info);
+bool gba_cart_detect_rom_size(uint32_t* size);
+bool gba_cart_header_valid(const uint8_t* header);
+
+// Memoria de partida en el bus de CS2 (SRAM/FRAM y Flash): A0-A15 en AD0-AD15
+// y los datos D0-D7 en A16-A23
+void gba_cart_save_begin(void);
+void gba_cart_save_end(void);
+bool gba_cart_save_read(uint16_t address, uint8_t* value);
+bool gba_cart_save_write(uint16_t address, uint8_t value);
+
+// EEPROM serie: un bit por acceso en AD0 (un valor por byte del array)
+bool gba_cart_eeprom_write_bits(const uint8_t* bits, size_t count);
+bool gba_cart_eeprom_read_bits(uint8_t* bits, size_t count);
+bool gba_cart_eeprom_reset(void);
+
+#endif // GBA_CART_H
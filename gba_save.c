@@ -0,0 +1,489 @@
+#include "gba_save.h"
+#include <storage/storage.h>
+#include <string.h>
+
+// Identificadores que la librería de Nintendo deja en la ROM
+static const struct {
+    const char* id;
+    GBASaveType type;
+} gba_save_ids[] = {
+    {"EEPROM_V", GBA_SAVE_EEPROM},
+    {"SRAM_F_V", GBA_SAVE_SRAM},
+    {"SRAM_V", GBA_SAVE_SRAM},
+    {"FLASH1M_V", GBA_SAVE_FLASH_128K},
+    {"FLASH512_V", GBA_SAVE_FLASH_64K},
+    {"FLASH_V", GBA_SAVE_FLASH_64K},
+};
+
+// IDs de Flash conocidos: (dispositivo << 8) | fabricante
+static const uint16_t gba_save_flash_64k_ids[] = {0xD4BF, 0x1CC2, 0x1B32, 0x3D1F};
+static const uint16_t gba_save_flash_128k_ids[] = {0x1362, 0x09C2};
+#define GBA_SAVE_FLASH_ATMEL 0x1F
+
+// Comandos de la Flash
+#define GBA_SAVE_FLASH_CMD_ID_ENTER 0x90
+#define GBA_SAVE_FLASH_CMD_ID_EXIT  0xF0
+#define GBA_SAVE_FLASH_CMD_ERASE    0x80
+#define GBA_SAVE_FLASH_CMD_SECTOR   0x30
+#define GBA_SAVE_FLASH_CMD_PROGRAM  0xA0
+#define GBA_SAVE_FLASH_CMD_BANK     0xB0
+
+// ---- Búsqueda de identificadores en la ROM ----
+
+void gba_save_scanner_init(GBASaveScanner* scanner) {
+    memset(scanner, 0, sizeof(GBASaveScanner));
+    scanner->found = GBA_SAVE_NONE;
+}
+
+// Byte 'index' de la concatenación tail + data
+static uint8_t gba_save_scanner_byte(const GBASaveScanner* scanner, const uint8_t* data, size_t index) {
+    return (index < scanner->tail_length) ? scanner->tail[index] : data[index - scanner->tail_length];
+}
+
+void gba_save_scanner_feed(GBASaveScanner* scanner, const uint8_t* data, size_t length) {
+    if(!scanner || !data || length == 0) return;
+
+    size_t total = scanner->tail_length + length;
+    uint32_t start = scanner->offset - scanner->tail_length;
+
+    if(scanner->found == GBA_SAVE_NONE) {
+        // Primera posición alineada a 4 bytes dentro de tail + data
+        size_t first = (4 - (start & 3)) & 3;
+        for(size_t pos = first; pos < total && scanner->found == GBA_SAVE_NONE; pos += 4) {
+            uint8_t c = gba_save_scanner_byte(scanner, data, pos);
+            if(c != 'E' && c != 'S' && c != 'F') continue;
+
+            for(size_t i = 0; i < COUNT_OF(gba_save_ids); i++) {
+                size_t id_length = strlen(gba_save_ids[i].id);
+                if(pos + id_length > total) continue;
+
+                size_t k = 0;
+                while(k < id_length &&
+                      gba_save_scanner_byte(scanner, data, pos + k) == (uint8_t)gba_save_ids[i].id[k]) {
+                    k++;
+                }
+                if(k == id_length) {
+                    scanner->found = gba_save_ids[i].type;
+                    FURI_LOG_I("GBA_SAVE", "%s en 0x%06lX", gba_save_ids[i].id, start + pos);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Guardar los últimos bytes por si un identificador queda cortado
+    size_t keep = (total < sizeof(scanner->tail)) ? total : sizeof(scanner->tail);
+    uint8_t tail[sizeof(scanner->tail)];
+    for(size_t i = 0; i < keep; i++) {
+        tail[i] = gba_save_scanner_byte(scanner, data, total - keep + i);
+    }
+    memcpy(scanner->tail, tail, keep);
+    scanner->tail_length = keep;
+    scanner->offset += length;
+}
+
+// ---- Flash ----
+
+static void gba_save_flash_command(uint8_t command) {
+    gba_cart_save_write(0x5555, 0xAA);
+    gba_cart_save_write(0x2AAA, 0x55);
+    gba_cart_save_write(0x5555, command);
+}
+
+// Lee el ID de la Flash. Los comandos escriben en 0x5555 y 0x2AAA: si resulta
+// ser una SRAM se restauran sus valores originales
+static uint16_t gba_save_flash_read_id(void) {
+    uint8_t original[2] = {0xFF, 0xFF};
+    gba_cart_save_read(0x5555, &original[0]);
+    gba_cart_save_read(0x2AAA, &original[1]);
+
+    gba_save_flash_command(GBA_SAVE_FLASH_CMD_ID_ENTER);
+    furi_delay_ms(20);
+    uint8_t manufacturer = 0xFF;
+    uint8_t device = 0xFF;
+    gba_cart_save_read(0x0000, &manufacturer);
+    gba_cart_save_read(0x0001, &device);
+    gba_save_flash_command(GBA_SAVE_FLASH_CMD_ID_EXIT);
+    furi_delay_ms(20);
+
+    uint16_t id = (device << 8) | manufacturer;
+    bool known = false;
+    for(size_t i = 0; i < COUNT_OF(gba_save_flash_64k_ids); i++) {
+        if(gba_save_flash_64k_ids[i] == id) known = true;
+    }
+    for(size_t i = 0; i < COUNT_OF(gba_save_flash_128k_ids); i++) {
+        if(gba_save_flash_128k_ids[i] == id) known = true;
+    }
+    if(!known) {
+        gba_cart_save_write(0x5555, original[0]);
+        gba_cart_save_write(0x2AAA, original[1]);
+    }
+    return id;
+}
+
+static GBASaveType gba_save_flash_type(uint16_t id) {
+    for(size_t i = 0; i < COUNT_OF(gba_save_flash_64k_ids); i++) {
+        if(gba_save_flash_64k_ids[i] == id) return GBA_SAVE_FLASH_64K;
+    }
+    for(size_t i = 0; i < COUNT_OF(gba_save_flash_128k_ids); i++) {
+        if(gba_save_flash_128k_ids[i] == id) return GBA_SAVE_FLASH_128K;
+    }
+    return GBA_SAVE_NONE;
+}
+
+static void gba_save_flash_set_bank(uint8_t bank) {
+    gba_save_flash_command(GBA_SAVE_FLASH_CMD_BANK);
+    gba_cart_save_write(0x0000, bank);
+}
+
+// Espera a que la Flash termine (la lectura devuelve el valor escrito)
+static bool gba_save_flash_wait(uint16_t address, uint8_t expected, uint32_t timeout_ms) {
+    uint32_t start = furi_get_tick();
+    uint8_t value;
+    do {
+        if(gba_cart_save_read(address, &value) && value == expected) return true;
+    } while(furi_get_tick() - start < furi_ms_to_ticks(timeout_ms));
+    return false;
+}
+
+static bool gba_save_flash_erase_sector(uint16_t address) {
+    gba_save_flash_command(GBA_SAVE_FLASH_CMD_ERASE);
+    gba_cart_save_write(0x5555, 0xAA);
+    gba_cart_save_write(0x2AAA, 0x55);
+    gba_cart_save_write(address, GBA_SAVE_FLASH_CMD_SECTOR);
+    return gba_save_flash_wait(address, 0xFF, GBA_SAVE_FLASH_ERASE_TIMEOUT_MS);
+}
+
+// Programa un sector de 4 KB. Las Atmel escriben páginas de 128 bytes (con
+// borrado incluido); el resto borra el sector y programa byte a byte
+static bool gba_save_flash_write_sector(uint16_t address, const uint8_t* data, bool atmel) {
+    if(atmel) {
+        for(size_t page = 0; page < GBA_SAVE_FLASH_SECTOR; page += GBA_SAVE_FLASH_PAGE) {
+            gba_save_flash_command(GBA_SAVE_FLASH_CMD_PROGRAM);
+            for(size_t i = 0; i < GBA_SAVE_FLASH_PAGE; i++) {
+                gba_cart_save_write(address + page + i, data[page + i]);
+            }
+            uint16_t last = address + page + GBA_SAVE_FLASH_PAGE - 1;
+            if(!gba_save_flash_wait(last, data[page + GBA_SAVE_FLASH_PAGE - 1], GBA_SAVE_WRITE_TIMEOUT_MS)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if(!gba_save_flash_erase_sector(address)) return false;
+    for(size_t i = 0; i < GBA_SAVE_FLASH_SECTOR; i++) {
+        // Tras el borrado todo es 0xFF: no hace falta programarlo
+        if(data[i] == 0xFF) continue;
+        gba_save_flash_command(GBA_SAVE_FLASH_CMD_PROGRAM);
+        gba_cart_save_write(address + i, data[i]);
+        if(!gba_save_flash_wait(address + i, data[i], GBA_SAVE_WRITE_TIMEOUT_MS)) return false;
+    }
+    return true;
+}
+
+// ---- EEPROM ----
+
+static uint8_t gba_save_eeprom_address_bits(GBASaveType type) {
+    return (type == GBA_SAVE_EEPROM_512) ? 6 : 14;
+}
+
+// Petición: 2 bits de comando, dirección de bloque (MSB primero), datos
+// opcionales y un bit de parada a 0
+static size_t gba_save_eeprom_request(uint8_t* bits, bool read, uint16_t block, uint8_t address_bits, const uint8_t* data) {
+    size_t count = 0;
+    bits[count++] = 1;
+    bits[count++] = read ? 1 : 0;
+    for(int i = address_bits - 1; i >= 0; i--) {
+        bits[count++] = (block >> i) & 1;
+    }
+    if(data) {
+        for(size_t byte = 0; byte < GBA_SAVE_EEPROM_BLOCK; byte++) {
+            for(int i = 7; i >= 0; i--) {
+                bits[count++] = (data[byte] >> i) & 1;
+            }
+        }
+    }
+    bits[count++] = 0;
+    return count;
+}
+
+// Lee un bloque de 8 bytes: la respuesta son 4 bits basura y 64 de datos
+static bool gba_save_eeprom_read_block(uint16_t block, uint8_t address_bits, uint8_t* data, uint8_t* raw) {
+    uint8_t bits[2 + 14 + 1];
+    size_t count = gba_save_eeprom_request(bits, true, block, address_bits, NULL);
+    if(!gba_cart_eeprom_write_bits(bits, count)) return false;
+
+    uint8_t response[4 + 64];
+    if(!gba_cart_eeprom_read_bits(response, sizeof(response))) return false;
+    if(raw) memcpy(raw, response, sizeof(response));
+
+    for(size_t byte = 0; byte < GBA_SAVE_EEPROM_BLOCK; byte++) {
+        uint8_t value = 0;
+        for(size_t i = 0; i < 8; i++) {
+            value = (value << 1) | response[4 + byte * 8 + i];
+        }
+        data[byte] = value;
+    }
+    return true;
+}
+
+static bool gba_save_eeprom_write_block(uint16_t block, uint8_t address_bits, const uint8_t* data) {
+    uint8_t bits[2 + 14 + 64 + 1];
+    size_t count = gba_save_eeprom_request(bits, false, block, address_bits, data);
+    if(!gba_cart_eeprom_write_bits(bits, count)) return false;
+
+    // La EEPROM devuelve 0 mientras escribe y 1 al terminar
+    uint32_t start = furi_get_tick();
+    uint8_t ready = 0;
+    do {
+        if(!gba_cart_eeprom_read_bits(&ready, 1)) return false;
+        if(ready) return true;
+    } while(furi_get_tick() - start < furi_ms_to_ticks(GBA_SAVE_WRITE_TIMEOUT_MS));
+    return false;
+}
+
+// Una petición con el ancho de dirección equivocado no obtiene respuesta y
+// la línea se queda en alto. Heurística: si algún bit de la respuesta es 0,
+// la EEPROM ha entendido la petición. Una EEPROM vacía (todo 0xFF) sólo se
+// distingue por los bits basura, que suelen ser 0
+static bool gba_save_eeprom_answers(uint8_t address_bits) {
+    uint8_t data[GBA_SAVE_EEPROM_BLOCK];
+    uint8_t raw[4 + 64];
+    if(!gba_save_eeprom_read_block(0, address_bits, data, raw)) return false;
+    for(size_t i = 0; i < sizeof(raw); i++) {
+        if(!raw[i]) return true;
+    }
+    return false;
+}
+
+// Primero la petición de 14 bits: una EEPROM de 512 bytes también la
+// contesta (el bloque 0 empieza con 6 bits a 0). La de 6 bits deja a una de
+// 8 KB esperando el resto de la dirección, por eso se reinicia la EEPROM
+// después de cada intento y sólo la de 512 bytes contesta a las dos
+static GBASaveType gba_save_eeprom_size(void) {
+    bool wide = gba_save_eeprom_answers(14);
+    gba_cart_eeprom_reset();
+    bool narrow = gba_save_eeprom_answers(6);
+    gba_cart_eeprom_reset();
+
+    if(narrow) return GBA_SAVE_EEPROM_512;
+    if(wide) return GBA_SAVE_EEPROM_8K;
+    return GBA_SAVE_NONE;
+}
+
+// ---- Detección ----
+
+// Patrones complementarios de la prueba de SRAM: el bus abierto o un valor
+// retenido en el bus no pueden devolver los dos
+static const uint8_t gba_save_sram_patterns[] = {0x5A, 0xA5};
+
+// Sondeo mínimo cuando la ROM no tiene identificador: ID de Flash, prueba de
+// escritura en SRAM (restaurando el byte) y por último la EEPROM
+GBASaveType gba_save_probe(void) {
+    GBASaveType type = GBA_SAVE_NONE;
+    gba_cart_save_begin();
+
+    uint16_t id = gba_save_flash_read_id();
+    type = gba_save_flash_type(id);
+    if(type != GBA_SAVE_NONE) {
+        FURI_LOG_I("GBA_SAVE", "Flash detectada (ID 0x%04X)", id);
+    } else {
+        uint8_t original = 0;
+        if(gba_cart_save_read(0x0000, &original)) {
+            bool sram = true;
+            for(size_t i = 0; sram && i < COUNT_OF(gba_save_sram_patterns); i++) {
+                uint8_t check = 0;
+                sram = gba_cart_save_write(0x0000, gba_save_sram_patterns[i]) &&
+                       gba_cart_save_read(0x0000, &check) && check == gba_save_sram_patterns[i];
+            }
+            gba_cart_save_write(0x0000, original);
+            if(sram) {
+                type = GBA_SAVE_SRAM;
+                FURI_LOG_I("GBA_SAVE", "SRAM detectada");
+            }
+        }
+    }
+    gba_cart_save_end();
+
+    if(type == GBA_SAVE_NONE) {
+        type = gba_save_eeprom_size();
+        if(type != GBA_SAVE_NONE) FURI_LOG_I("GBA_SAVE", "EEPROM detectada");
+    }
+    return type;
+}
+
+// Convierte el resultado de la búsqueda en la ROM en un tipo concreto: la
+// EEPROM necesita sondear su tamaño y sin identificador se sondea todo
+GBASaveType gba_save_resolve(GBASaveType scanned) {
+    switch(scanned) {
+        case GBA_SAVE_NONE: return gba_save_probe();
+        case GBA_SAVE_EEPROM: {
+            GBASaveType type = gba_save_eeprom_size();
+            // Sin respuesta clara se asume 8 KB: cubre también los 512 bytes
+            return (type != GBA_SAVE_NONE) ? type : GBA_SAVE_EEPROM_8K;
+        }
+        default: return scanned;
+    }
+}
+
+uint32_t gba_save_get_size(GBASaveType type) {
+    switch(type) {
+        case GBA_SAVE_SRAM: return GBA_SAVE_SRAM_SIZE;
+        case GBA_SAVE_EEPROM_512: return 512;
+        case GBA_SAVE_EEPROM_8K: return 8192;
+        case GBA_SAVE_FLASH_64K: return GBA_SAVE_FLASH_BANK;
+        case GBA_SAVE_FLASH_128K: return 2 * GBA_SAVE_FLASH_BANK;
+        default: return 0;
+    }
+}
+
+const char* gba_save_get_name(GBASaveType type) {
+    switch(type) {
+        case GBA_SAVE_NONE: return "Ninguno";
+        case GBA_SAVE_SRAM: return "SRAM 32KB";
+        case GBA_SAVE_EEPROM: return "EEPROM";
+        case GBA_SAVE_EEPROM_512: return "EEPROM 512B";
+        case GBA_SAVE_EEPROM_8K: return "EEPROM 8KB";
+        case GBA_SAVE_FLASH_64K: return "Flash 64KB";
+        case GBA_SAVE_FLASH_128K: return "Flash 128KB";
+        default: return "?";
+    }
+}
+
+// ---- Copia y restauración ----
+
+// Lee un bloque de la partida. 'length' es múltiplo de 8 y no cruza bancos
+static bool gba_save_read(GBASaveType type, uint32_t offset, uint8_t* buffer, size_t length) {
+    if(type == GBA_SAVE_EEPROM_512 || type == GBA_SAVE_EEPROM_8K) {
+        uint8_t address_bits = gba_save_eeprom_address_bits(type);
+        for(size_t i = 0; i < length; i += GBA_SAVE_EEPROM_BLOCK) {
+            uint16_t block = (offset + i) / GBA_SAVE_EEPROM_BLOCK;
+            if(!gba_save_eeprom_read_block(block, address_bits, &buffer[i], NULL)) return false;
+        }
+        return true;
+    }
+
+    for(size_t i = 0; i < length; i++) {
+        if(!gba_cart_save_read((offset + i) & 0xFFFF, &buffer[i])) return false;
+    }
+    return true;
+}
+
+bool gba_save_backup(GBASaveType type, const char* path, GBDumpProgressCallback callback, void* context) {
+    uint32_t size = gba_save_get_size(type);
+    if(size == 0 || !path) return false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if(!success) FURI_LOG_E("GBA_SAVE", "No se pudo crear %s", path);
+
+    bool parallel = (type == GBA_SAVE_SRAM || type == GBA_SAVE_FLASH_64K || type == GBA_SAVE_FLASH_128K);
+    if(parallel) gba_cart_save_begin();
+
+    uint8_t* buffer = malloc(GB_DUMP_CHUNK_SIZE);
+    for(uint32_t offset = 0; success && offset < size; offset += GB_DUMP_CHUNK_SIZE) {
+        if(type == GBA_SAVE_FLASH_128K && (offset % GBA_SAVE_FLASH_BANK) == 0) {
+            gba_save_flash_set_bank(offset / GBA_SAVE_FLASH_BANK);
+        }
+        success = gba_save_read(type, offset, buffer, GB_DUMP_CHUNK_SIZE) &&
+                  storage_file_write(file, buffer, GB_DUMP_CHUNK_SIZE) == GB_DUMP_CHUNK_SIZE;
+        if(success && callback && !callback(offset + GB_DUMP_CHUNK_SIZE, size, false, context)) {
+            success = false;
+        }
+    }
+    free(buffer);
+
+    if(type == GBA_SAVE_FLASH_128K) gba_save_flash_set_bank(0);
+    if(parallel) gba_cart_save_end();
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(success) {
+        FURI_LOG_I("GBA_SAVE", "%s guardada en %s", gba_save_get_name(type), path);
+    } else {
+        FURI_LOG_E("GBA_SAVE", "Error copiando la partida");
+    }
+    return success;
+}
+
+// Escribe un sector (Flash), un bloque de 512 bytes (SRAM) o los bloques de
+// 8 bytes de la EEPROM y lo verifica leyéndolo de nuevo en 'check' (del
+// mismo tamaño que 'data')
+static bool gba_save_write(
+    GBASaveType type,
+    uint32_t offset,
+    const uint8_t* data,
+    uint8_t* check,
+    size_t length,
+    bool atmel) {
+    if(type == GBA_SAVE_EEPROM_512 || type == GBA_SAVE_EEPROM_8K) {
+        uint8_t address_bits = gba_save_eeprom_address_bits(type);
+        for(size_t i = 0; i < length; i += GBA_SAVE_EEPROM_BLOCK) {
+            uint16_t block = (offset + i) / GBA_SAVE_EEPROM_BLOCK;
+            if(!gba_save_eeprom_write_block(block, address_bits, &data[i])) return false;
+        }
+    } else if(type == GBA_SAVE_SRAM) {
+        for(size_t i = 0; i < length; i++) {
+            if(!gba_cart_save_write(offset + i, data[i])) return false;
+        }
+    } else if(!gba_save_flash_write_sector(offset & 0xFFFF, data, atmel)) {
+        return false;
+    }
+
+    return gba_save_read(type, offset, check, length) && memcmp(check, data, length) == 0;
+}
+
+bool gba_save_restore(GBASaveType type, const char* path, GBDumpProgressCallback callback, void* context) {
+    uint32_t size = gba_save_get_size(type);
+    if(size == 0 || !path) return false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING);
+    if(!success) {
+        FURI_LOG_E("GBA_SAVE", "No se pudo abrir %s", path);
+    } else if(storage_file_size(file) != size) {
+        FURI_LOG_E("GBA_SAVE", "%s no es una partida de %s", path, gba_save_get_name(type));
+        success = false;
+    }
+
+    bool parallel = (type == GBA_SAVE_SRAM || type == GBA_SAVE_FLASH_64K || type == GBA_SAVE_FLASH_128K);
+    bool flash = (type == GBA_SAVE_FLASH_64K || type == GBA_SAVE_FLASH_128K);
+    bool atmel = false;
+    if(success && parallel) {
+        gba_cart_save_begin();
+        if(flash) atmel = (gba_save_flash_read_id() & 0xFF) == GBA_SAVE_FLASH_ATMEL;
+    }
+
+    // Sectores de 4 KB en Flash; bloques de 512 bytes en SRAM y EEPROM
+    size_t step = flash ? GBA_SAVE_FLASH_SECTOR : GB_DUMP_CHUNK_SIZE;
+    uint8_t* buffer = malloc(GBA_SAVE_FLASH_SECTOR);
+    uint8_t* check = malloc(GBA_SAVE_FLASH_SECTOR);
+    for(uint32_t offset = 0; success && offset < size; offset += step) {
+        if(type == GBA_SAVE_FLASH_128K && (offset % GBA_SAVE_FLASH_BANK) == 0) {
+            gba_save_flash_set_bank(offset / GBA_SAVE_FLASH_BANK);
+        }
+        success = storage_file_read(file, buffer, step) == step &&
+                  gba_save_write(type, offset, buffer, check, step, atmel);
+        if(!success) FURI_LOG_E("GBA_SAVE", "Error escribiendo en 0x%05lX", offset);
+        if(success && callback && !callback(offset + step, size, false, context)) {
+            success = false;
+        }
+    }
+    free(check);
+    free(buffer);
+
+    if(type == GBA_SAVE_FLASH_128K) gba_save_flash_set_bank(0);
+    if(parallel) gba_cart_save_end();
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(success) FURI_LOG_I("GBA_SAVE", "Partida restaurada desde %s", path);
+    return success;
+}
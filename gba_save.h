@@ -0,0 +1,53 @@
+#ifndef GBA_SAVE_H
+#define GBA_SAVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "gba_cart.h"
+#include "gb_dump.h"
+
+// Tipos de memoria de partida de GBA
+typedef enum {
+    GBA_SAVE_NONE = 0,
+    GBA_SAVE_SRAM,         // SRAM/FRAM 32 KB (SRAM_V, SRAM_F_V)
+    GBA_SAVE_EEPROM,       // EEPROM_V: tamaño aún sin resolver
+    GBA_SAVE_EEPROM_512,   // 4 Kbit, direcciones de 6 bits
+    GBA_SAVE_EEPROM_8K,    // 64 Kbit, direcciones de 14 bits
+    GBA_SAVE_FLASH_64K,    // FLASH_V, FLASH512_V
+    GBA_SAVE_FLASH_128K,   // FLASH1M_V (dos bancos de 64 KB)
+    GBA_SAVE_TYPE_COUNT
+} GBASaveType;
+
+#define GBA_SAVE_ID_MAX_LENGTH  10      // "FLASH512_V"
+#define GBA_SAVE_SRAM_SIZE      0x8000
+#define GBA_SAVE_FLASH_BANK     0x10000
+#define GBA_SAVE_FLASH_SECTOR   0x1000
+#define GBA_SAVE_FLASH_PAGE     128     // Atmel: programa páginas, sin borrado
+#define GBA_SAVE_EEPROM_BLOCK   8
+
+// Tiempos máximos de la Flash y la EEPROM
+#define GBA_SAVE_FLASH_ERASE_TIMEOUT_MS  1000
+#define GBA_SAVE_WRITE_TIMEOUT_MS        20
+
+// Busca los identificadores de la librería de guardado de Nintendo mientras
+// se vuelca la ROM. Están alineados a 4 bytes; 'tail' guarda el final del
+// bloque anterior para encontrarlos aunque caigan entre dos bloques
+typedef struct {
+    uint8_t tail[GBA_SAVE_ID_MAX_LENGTH - 1];
+    size_t tail_length;
+    uint32_t offset;       // Bytes recibidos hasta ahora
+    GBASaveType found;
+} GBASaveScanner;
+
+// Funciones de la memoria de partida
+void gba_save_scanner_init(GBASaveScanner* scanner);
+void gba_save_scanner_feed(GBASaveScanner* scanner, const uint8_t* data, size_t length);
+GBASaveType gba_save_probe(void);
+GBASaveType gba_save_resolve(GBASaveType scanned);
+uint32_t gba_save_get_size(GBASaveType type);
+const char* gba_save_get_name(GBASaveType type);
+bool gba_save_backup(GBASaveType type, const char* path, GBDumpProgressCallback callback, void* context);
+bool gba_save_restore(GBASaveType type, const char* path, GBDumpProgressCallback callback, void* context);
+
+#endif // GBA_SAVE_H
@@ -2,13 +2,24 @@
 #include <gui/gui.h>
 #include <input/input.h>
 #include <stdlib.h>
+#include <string.h>
 #include <notification/notification_messages.h>
 #include <furi_hal_power.h>
 #include <furi_hal_spi.h>
+#include <storage/storage.h>
 // Incluir la API que creamos
 // En una aplicación real, esto sería un archivo separado
 #include "mcp23s17_api.h"
+#include "shift_595.h"
+#include "gb_address.h"
 #include "gb_cart.h"
+#include "gb_mapper.h"
+#include "gb_dump.h"
+#include "gb_camera.h"
+#include "gb_batch.h"
+#include "gb_selftest.h"
+#include "gba_cart.h"
+#include "gba_save.h"
 
 // Dirección I2C del MCP23S17 (0x20 por defecto)
 #define MCP23S17_ADDRESS 0x20
@@ -17,22 +28,123 @@ typedef struct {
     FuriMutex* mutex;
     MCP23S17* mcp1;
     MCP23S17* mcp2;
+    Shift595* shift;              // Cadena 74HC595 (backend de direcciones alternativo)
+    GBAddressBackend address;     // Backend de direcciones activo
+    GBAddressType address_type;
     GBCartInfo cart_info;
+    GBMapper mapper;
+    bool gba_mode;                // Cartucho de Game Boy Advance
+    GBACartInfo gba_info;
+    GBASaveType gba_save_type;    // Tipo de partida del último volcado GBA
     bool cart_detected;
     bool reading;
+    bool dumping;
+    uint32_t dump_done;
+    uint32_t dump_total;
+    const char* dump_label;   // Qué se está volcando (ROM / Save / Fotos)
+    bool dump_in_kb;          // Progreso en KB o en unidades (fotos)
+    bool dump_paused;         // Esperando a que se reinserte el cartucho
+    GBDumpFormat dump_format; // RAW o comprimido (GBZ)
+    bool verify_sampled_ok;   // La verificación rápida pasó: la siguiente es completa
+    char status[32];      // Resultado de la última operación
     int scroll_position;  // Nueva variable para el scroll
+    ViewPort* view_port;
+    GBBatch* batch;       // Modo por lotes activo (NULL si no)
+    bool batch_stopping;  // Se pidió parar el lote; se libera al detenerse
+    File* trace_file;     // Traza binaria del bus en curso (NULL si no)
 } GBCartApp;
 
+// Pista de Mantener Atrás: el perfil activo (direcciones + señales, o GBA)
+static void draw_hardware_hint(Canvas* canvas, GBCartApp* app, int y) {
+    char buffer[32];
+    if (app->gba_mode) {
+        snprintf(buffer, sizeof(buffer), "Mant. Atras: GBA");
+    } else {
+        snprintf(buffer, sizeof(buffer), "Mant. Atras: %s+%s",
+                gb_address_get_name(app->address_type),
+                gb_cart_get_wiring_name(gb_cart_get_wiring()));
+    }
+    canvas_draw_str(canvas, 0, y, buffer);
+}
+
 static void render_callback(Canvas* canvas, void* ctx) {
     GBCartApp* app = ctx;
     furi_mutex_acquire(app->mutex, FuriWaitForever);
 
     canvas_clear(canvas);
     canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str(canvas, 0, 10, "Game Boy Cart Reader");
+    canvas_draw_str(canvas, 0, 10, app->gba_mode ? "GBA Cart Reader" : "Game Boy Cart Reader");
 
-    if (app->reading) {
+    if (app->batch) {
+        // Modo por lotes: estado del worker
+        static const char* batch_states[] = {
+            "Inserta cartucho...", "Volcando...", "Cambia cartucho...", "Detenido"};
+        GBBatchStatus status;
+        char buffer[32];
+        gb_batch_get_status(app->batch, &status);
+        canvas_draw_str(canvas, 0, 22,
+                app->batch_stopping ? "Parando..." : batch_states[status.state]);
+        canvas_set_font(canvas, FontSecondary);
+        if (status.state == GB_BATCH_DUMPING && status.paused) {
+            canvas_draw_str(canvas, 0, 32, "Sin contacto! Reinserta");
+        } else if (status.state == GB_BATCH_DUMPING) {
+            snprintf(buffer, sizeof(buffer), "%s %luKB/%luKB", status.title,
+                    status.done / 1024, status.total / 1024);
+            canvas_draw_str(canvas, 0, 32, buffer);
+        }
+        snprintf(buffer, sizeof(buffer), "OK: %d  Error: %d", status.carts_ok, status.carts_failed);
+        canvas_draw_str(canvas, 0, 42, buffer);
+        canvas_draw_str(canvas, 0, 52, status.last_result);
+        canvas_draw_str(canvas, 0, 62, "Mant. OK: Salir del lote");
+    } else if (app->reading) {
         canvas_draw_str(canvas, 0, 30, "Leyendo cartucho...");
+    } else if (app->dumping) {
+        char buffer[32];
+        canvas_draw_str(canvas, 0, 30, app->dump_label);
+        if (app->dump_in_kb) {
+            snprintf(buffer, sizeof(buffer), "%luKB / %luKB",
+                    app->dump_done / 1024, app->dump_total / 1024);
+        } else {
+            snprintf(buffer, sizeof(buffer), "%lu / %lu",
+                    app->dump_done, app->dump_total);
+        }
+        canvas_draw_str(canvas, 0, 40, buffer);
+        if (app->dump_paused) {
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str(canvas, 0, 52, "Sin contacto! Reinserta");
+            canvas_draw_str(canvas, 0, 62, "el mismo cartucho");
+        }
+    } else if (app->cart_detected && app->gba_mode) {
+        // Información del cartucho de GBA
+        char buffer[32];
+        int y_pos = 30 - app->scroll_position;
+        
+        canvas_draw_str(canvas, 0, y_pos, "Titulo:");
+        canvas_draw_str(canvas, 0, y_pos + 10, app->gba_info.title);
+        
+        snprintf(buffer, sizeof(buffer), "Codigo: %s-%s v%d",
+                app->gba_info.game_code, app->gba_info.maker_code, app->gba_info.version);
+        canvas_draw_str(canvas, 0, y_pos + 20, buffer);
+        
+        snprintf(buffer, sizeof(buffer), "ROM: %luKB", app->gba_info.rom_size / 1024);
+        canvas_draw_str(canvas, 0, y_pos + 30, buffer);
+        
+        snprintf(buffer, sizeof(buffer), "Save: %s", gba_save_get_name(app->gba_save_type));
+        canvas_draw_str(canvas, 0, y_pos + 40, buffer);
+        
+        snprintf(buffer, sizeof(buffer), "Checksum: 0x%02X", app->gba_info.checksum);
+        canvas_draw_str(canvas, 0, y_pos + 50, buffer);
+        
+        canvas_draw_str(canvas, 0, y_pos + 60, app->status);
+        canvas_draw_str(canvas, 0, y_pos + 70, "Derecha: Volcar ROM+Save");
+        snprintf(buffer, sizeof(buffer), "Mant. Der.: %s",
+                app->dump_format == GB_DUMP_FORMAT_GBZ ? "GBZ" : "RAW");
+        canvas_draw_str(canvas, 0, y_pos + 80, buffer);
+        canvas_draw_str(canvas, 0, y_pos + 90, "Mant. Izq.: Restaurar .sav");
+        draw_hardware_hint(canvas, app, y_pos + 100);
+        
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str(canvas, 0, 120, "Arriba/Abajo: Scroll");
     } else if (app->cart_detected) {
         // Mostrar información del cartucho con scroll
         char buffer[32];
@@ -69,15 +181,373 @@ static void render_callback(Canvas* canvas, void* ctx) {
                 app->cart_info.checksum);
         canvas_draw_str(canvas, 0, y_pos + 80, buffer);
 
+        // Resultado del último volcado
+        canvas_draw_str(canvas, 0, y_pos + 90, app->status);
+        canvas_draw_str(canvas, 0, y_pos + 100, "Derecha: Volcar ROM");
+        snprintf(buffer, sizeof(buffer), "Mant. Der.: %s",
+                app->dump_format == GB_DUMP_FORMAT_GBZ ? "GBZ" : "RAW");
+        canvas_draw_str(canvas, 0, y_pos + 110, buffer);
+        if (gb_camera_is_camera(&app->mapper)) {
+            canvas_draw_str(canvas, 0, y_pos + 120, "Izquierda: Fotos");
+        }
+        draw_hardware_hint(canvas, app, y_pos + 130);
+        canvas_draw_str(canvas, 0, y_pos + 140,
+                app->verify_sampled_ok ? "Mant. Izq.: Verif. completa" : "Mant. Izq.: Verif. rapida");
+
         // Dibujar indicador de scroll
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 0, 120, "Arriba/Abajo: Scroll");
     } else {
         canvas_draw_str(canvas, 0, 30, "No hay cartucho detectado");
-        canvas_draw_str(canvas, 0, 40, "Presiona OK para leer");
+        if (app->status[0]) {
+            // Resultado del autotest u otra operación sin cartucho leído
+            canvas_set_font(canvas, FontSecondary);
+            canvas_draw_str(canvas, 0, 40, app->status);
+        } else {
+            canvas_draw_str(canvas, 0, 40, "Presiona OK para leer");
+            canvas_set_font(canvas, FontSecondary);
+        }
+        canvas_draw_str(canvas, 0, 50, "Mant. OK: Modo por lotes");
+        draw_hardware_hint(canvas, app, 60);
+    }
+
+    furi_mutex_release(app->mutex);
+}
+
+// Progreso del volcado: se llama desde el bucle principal sin el mutex tomado
+static bool dump_progress_callback(uint32_t done, uint32_t total, bool paused, void* ctx) {
+    GBCartApp* app = ctx;
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->dump_done = done;
+    app->dump_total = total;
+    app->dump_paused = paused;
+    furi_mutex_release(app->mutex);
+    view_port_update(app->view_port);
+    return true;
+}
+
+// Marca el inicio de una fase del volcado en pantalla
+static void dump_set_phase(GBCartApp* app, const char* label, uint32_t total, bool in_kb) {
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->dumping = true;
+    app->dump_label = label;
+    app->dump_in_kb = in_kb;
+    app->dump_paused = false;
+    app->dump_done = 0;
+    app->dump_total = total;
+    furi_mutex_release(app->mutex);
+    view_port_update(app->view_port);
+}
+
+// Vuelca la ROM y, si la hay, la partida guardada del cartucho actual a la SD
+static void dump_rom(GBCartApp* app, NotificationApp* notifications) {
+    dump_set_phase(app, "Volcando ROM...", app->cart_info.rom_size, true);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, APP_DATA_PATH(""));
+    furi_record_close(RECORD_STORAGE);
+
+    const char* name = app->cart_info.title[0] ? app->cart_info.title : "ROM";
+    const char* ext = (app->dump_format == GB_DUMP_FORMAT_GBZ) ? GB_DUMP_COMPRESSED_EXT : "";
+    char path[64];
+    snprintf(path, sizeof(path), APP_DATA_PATH("%s.gb%s"), name, ext);
+
+    GBDumpResult result;
+    bool success = gb_dump_rom(&app->mapper, &app->cart_info, path, app->dump_format,
+                              dump_progress_callback, app, &result);
+
+    // Partida guardada
+    bool save_success = true;
+    GBDumpResult save_result;
+    if (success && app->mapper.ram_size > 0) {
+        dump_set_phase(app, "Volcando Save...", app->mapper.ram_size, true);
+        snprintf(path, sizeof(path), APP_DATA_PATH("%s.sav%s"), name, ext);
+        save_success = gb_dump_save(&app->mapper, path, app->dump_format,
+                                   dump_progress_callback, app, &save_result);
+    }
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->dumping = false;
+    if (!success) {
+        snprintf(app->status, sizeof(app->status), "Dump: %s",
+                gb_dump_get_error_string(result.error));
+    } else if (!save_success) {
+        snprintf(app->status, sizeof(app->status), "Save: %s",
+                gb_dump_get_error_string(save_result.error));
+    } else if (result.size_mismatch) {
+        snprintf(app->status, sizeof(app->status), "Dump: %luKB (header %luKB)",
+                result.detected_size / 1024, result.header_size / 1024);
+    } else {
+        snprintf(app->status, sizeof(app->status), "Dump: OK %luKB -> %luKB",
+                result.bytes_read / 1024, result.bytes_written / 1024);
+    }
+    furi_mutex_release(app->mutex);
+
+    notification_message(notifications, (success && save_success) ? &sequence_success : &sequence_error);
+}
+
+// Busca el tipo de partida en cada bloque de la ROM mientras se vuelca
+static void gba_scan_callback(const uint8_t* data, size_t length, void* ctx) {
+    gba_save_scanner_feed(ctx, data, length);
+}
+
+// Vuelca la ROM de GBA y su partida. El tipo de partida sale de la misma
+// pasada del volcado; sólo si no aparece se sondea el cartucho
+static void dump_gba(GBCartApp* app, NotificationApp* notifications) {
+    dump_set_phase(app, "Volcando ROM GBA...", app->gba_info.rom_size, true);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, APP_DATA_PATH(""));
+    furi_record_close(RECORD_STORAGE);
+
+    const char* name = app->gba_info.title[0] ? app->gba_info.title : "ROM";
+    const char* ext = (app->dump_format == GB_DUMP_FORMAT_GBZ) ? GB_DUMP_COMPRESSED_EXT : "";
+    char path[64];
+    snprintf(path, sizeof(path), APP_DATA_PATH("%s.gba%s"), name, ext);
+
+    GBASaveScanner scanner;
+    gba_save_scanner_init(&scanner);
+    GBDumpResult result;
+    bool success = gb_dump_gba_rom(path, app->dump_format, app->gba_info.rom_size,
+                                  gba_scan_callback, &scanner, dump_progress_callback, app, &result);
+
+    // Partida guardada: siempre RAW para poder restaurarla
+    bool save_success = true;
+    GBASaveType save_type = GBA_SAVE_NONE;
+    if (success) {
+        save_type = gba_save_resolve(scanner.found);
+        if (save_type != GBA_SAVE_NONE) {
+            dump_set_phase(app, "Volcando Save...", gba_save_get_size(save_type), true);
+            snprintf(path, sizeof(path), APP_DATA_PATH("%s.sav"), name);
+            save_success = gba_save_backup(save_type, path, dump_progress_callback, app);
+        }
+    }
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->dumping = false;
+    app->gba_save_type = save_type;
+    if (!success) {
+        snprintf(app->status, sizeof(app->status), "Dump: %s",
+                gb_dump_get_error_string(result.error));
+    } else if (!save_success) {
+        snprintf(app->status, sizeof(app->status), "Save: ERROR");
+    } else {
+        snprintf(app->status, sizeof(app->status), "Dump: OK %luKB -> %luKB",
+                result.bytes_read / 1024, result.bytes_written / 1024);
+    }
+    furi_mutex_release(app->mutex);
+
+    notification_message(notifications, (success && save_success) ? &sequence_success : &sequence_error);
+}
+
+// Escribe <titulo>.sav en la memoria de partida del cartucho de GBA
+static void restore_gba_save(GBCartApp* app, NotificationApp* notifications) {
+    // Sin volcado previo no se conoce el tipo: sondear el cartucho
+    GBASaveType save_type = gba_save_resolve(app->gba_save_type);
+    bool success = (save_type != GBA_SAVE_NONE);
+
+    if (success) {
+        dump_set_phase(app, "Restaurando Save...", gba_save_get_size(save_type), true);
+        const char* name = app->gba_info.title[0] ? app->gba_info.title : "ROM";
+        char path[64];
+        snprintf(path, sizeof(path), APP_DATA_PATH("%s.sav"), name);
+        success = gba_save_restore(save_type, path, dump_progress_callback, app);
+    }
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->dumping = false;
+    app->gba_save_type = save_type;
+    snprintf(app->status, sizeof(app->status), "Restaurar: %s",
+            success ? "OK" : (save_type == GBA_SAVE_NONE ? "sin save" : "ERROR"));
+    furi_mutex_release(app->mutex);
+
+    notification_message(notifications, success ? &sequence_success : &sequence_error);
+}
+
+// Cambia entre cartuchos de Game Boy y de GBA. El bus de GBA necesita los
+// dos MCP23S17 (AD0-AD15 multiplexados en el MCP1). El cartucho leído deja
+// de valer: hay que volver a leerlo en el otro modo
+static void toggle_gba_mode(GBCartApp* app, NotificationApp* notifications) {
+    bool gba_mode = !app->gba_mode;
+    bool success = gba_mode ? gba_cart_init(app->mcp1, app->mcp2) :
+                              gb_cart_init(&app->address, app->mcp2);
+    if (success) {
+        app->gba_mode = gba_mode;
+        app->gba_save_type = GBA_SAVE_NONE;
+        app->cart_detected = false;
+        app->verify_sampled_ok = false;
+        app->scroll_position = 0;
+        app->status[0] = '\0';
+    } else if (gba_mode) {
+        // Volver a dejar el bus en modo Game Boy
+        gb_cart_init(&app->address, app->mcp2);
+    }
+    gb_mapper_invalidate(&app->mapper);
+    notification_message(notifications, success ? &sequence_success : &sequence_error);
+}
+
+// Compara el cartucho con <titulo>.gb de la SD. La primera vez se hace un
+// muestreo rápido; si pasa, la siguiente compara la ROM completa
+static void verify_rom(GBCartApp* app, NotificationApp* notifications) {
+    bool sampled = !app->verify_sampled_ok;
+    dump_set_phase(app, sampled ? "Verificando (rapido)..." : "Verificando...", 0, false);
+
+    const char* name = app->cart_info.title[0] ? app->cart_info.title : "ROM";
+    char path[64];
+    snprintf(path, sizeof(path), APP_DATA_PATH("%s.gb"), name);
+
+    GBVerifyResult result;
+    bool success = gb_dump_verify_rom(&app->mapper, path, sampled,
+                                     dump_progress_callback, app, &result);
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->dumping = false;
+    if (!success) {
+        snprintf(app->status, sizeof(app->status), "Verif.: %s",
+                gb_dump_get_error_string(result.error));
+    } else if (result.size_mismatch) {
+        snprintf(app->status, sizeof(app->status), "Tam.: SD %luK, cart %luK",
+                result.file_size / 1024, result.cart_size / 1024);
+    } else if (!result.match) {
+        snprintf(app->status, sizeof(app->status), "Distinto en 0x%06lX",
+                result.mismatch_offset);
+    } else {
+        snprintf(app->status, sizeof(app->status), "Verif. %s: OK",
+                sampled ? "rapida" : "completa");
     }
+    app->verify_sampled_ok = success && result.match && sampled;
+    furi_mutex_release(app->mutex);
+
+    notification_message(notifications, (success && result.match) ? &sequence_success : &sequence_error);
+}
+
+// Comprueba las líneas del bus y muestra el primer fallo. El test mueve los
+// registros del MBC, así que el estado cacheado del mapper deja de valer
+static void run_selftest(GBCartApp* app, NotificationApp* notifications) {
+    GBSelfTestResult result;
+    bool success = gb_selftest_run(&app->address, app->mcp2, &result);
+
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    gb_mapper_invalidate(&app->mapper);
+    gb_selftest_describe(&result, app->status, sizeof(app->status));
+    furi_mutex_release(app->mutex);
+
+    notification_message(notifications,
+        (success && gb_selftest_passed(&result)) ? &sequence_success : &sequence_error);
+}
+
+// Extrae las fotos de una Game Boy Camera como BMP
+static void extract_photos(GBCartApp* app, NotificationApp* notifications) {
+    dump_set_phase(app, "Extrayendo fotos...", GB_CAMERA_PHOTO_SLOTS, false);
+
+    uint8_t photos = 0;
+    bool success = gb_camera_extract_photos(&app->mapper, APP_DATA_PATH("camera"),
+                                           dump_progress_callback, app, &photos);
 
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    app->dumping = false;
+    if (success) {
+        snprintf(app->status, sizeof(app->status), "Fotos: %d guardadas", photos);
+    } else {
+        snprintf(app->status, sizeof(app->status), "Fotos: ERROR");
+    }
     furi_mutex_release(app->mutex);
+
+    notification_message(notifications, success ? &sequence_success : &sequence_error);
+}
+
+// Prepara el hardware de direcciones: MCP1 o cadena de 74HC595. Los dos
+// usan PA4 (CS del MCP1 o latch de los 595), así que sólo uno está activo
+static bool address_backend_select(GBCartApp* app, GBAddressType type) {
+    FuriHalSpiBusHandle* spi = &furi_hal_spi_bus_handle_external;
+    
+    if (app->mcp1->initialized) {
+        mcp23s17_deinit(app->mcp1);
+    }
+    if (app->shift->initialized) {
+        shift_595_deinit(app->shift);
+    }
+    
+    app->address_type = type;
+    if (type == GB_ADDRESS_SHIFT_595) {
+        gb_address_setup_shift_595(&app->address, app->shift);
+        return shift_595_init(app->shift, spi, &gpio_ext_pa4, 2);
+    }
+    gb_address_setup_mcp23s17(&app->address, app->mcp1);
+    return mcp23s17_init(app->mcp1, 0, spi, &gpio_ext_pa4);
+}
+
+// Pasa al siguiente perfil de hardware: cableado MCP/Híbrido y, al dar la
+// vuelta, el siguiente backend de direcciones. Tras el último perfil de Game
+// Boy viene el modo GBA, y de GBA se vuelve al primero (MCP+MCP)
+static void cycle_hardware(GBCartApp* app, NotificationApp* notifications) {
+    if (app->gba_mode) {
+        toggle_gba_mode(app, notifications);
+        return;
+    }
+    
+    GBCartWiring wiring = gb_cart_get_wiring() + 1;
+    GBAddressType type = app->address_type;
+    bool to_gba = false;
+    if (wiring >= GB_CART_WIRING_COUNT) {
+        wiring = GB_CART_WIRING_MCP;
+        type = type + 1;
+        if (type >= GB_ADDRESS_TYPE_COUNT) {
+            // GBA necesita el MCP1 y las señales en el MCP2
+            type = GB_ADDRESS_MCP23S17;
+            to_gba = true;
+        }
+    }
+    
+    bool success = true;
+    if (type != app->address_type) {
+        success = address_backend_select(app, type) &&
+                  gb_cart_set_address_backend(&app->address);
+    }
+    success = gb_cart_set_wiring(wiring) && success;
+    gb_mapper_invalidate(&app->mapper);
+    
+    if (to_gba && success) {
+        toggle_gba_mode(app, notifications);
+        return;
+    }
+    notification_message(notifications, success ? &sequence_success : &sequence_error);
+}
+
+// Destino de la traza del bus: archivo en la SD
+static bool trace_write_callback(const uint8_t* data, size_t size, void* ctx) {
+    File* file = ctx;
+    return storage_file_write(file, data, size) == size;
+}
+
+// Activa o desactiva la grabación de la traza del bus
+static void toggle_trace(GBCartApp* app, NotificationApp* notifications) {
+    if (app->trace_file) {
+        mcp23s17_trace_stop();
+        storage_file_close(app->trace_file);
+        storage_file_free(app->trace_file);
+        furi_record_close(RECORD_STORAGE);
+        app->trace_file = NULL;
+        snprintf(app->status, sizeof(app->status), "Traza guardada");
+        notification_message(notifications, &sequence_success);
+        return;
+    }
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, APP_DATA_PATH(""));
+    app->trace_file = storage_file_alloc(storage);
+    if (!storage_file_open(app->trace_file, APP_DATA_PATH("trace.bin"), FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+        !mcp23s17_trace_start(trace_write_callback, app->trace_file)) {
+        storage_file_close(app->trace_file);
+        storage_file_free(app->trace_file);
+        furi_record_close(RECORD_STORAGE);
+        app->trace_file = NULL;
+        snprintf(app->status, sizeof(app->status), "Traza: ERROR");
+        notification_message(notifications, &sequence_error);
+        return;
+    }
+    snprintf(app->status, sizeof(app->status), "Traza: grabando");
+    notification_message(notifications, &sequence_success);
 }
 
 static void input_callback(InputEvent* input_event, void* ctx) {
@@ -93,11 +563,21 @@ int32_t gb_cart_app(void* p) {
     GBCartApp* app = malloc(sizeof(GBCartApp));
     app->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     app->cart_detected = false;
+    app->gba_mode = false;
+    app->gba_save_type = GBA_SAVE_NONE;
     app->reading = false;
+    app->dumping = false;
+    app->batch = NULL;
+    app->batch_stopping = false;
+    app->trace_file = NULL;
+    app->dump_format = GB_DUMP_FORMAT_RAW;
+    app->verify_sampled_ok = false;
+    app->status[0] = '\0';
     app->scroll_position = 0;  // Inicializar posición de scroll
     
     // Configurar la interfaz gráfica
     ViewPort* view_port = view_port_alloc();
+    app->view_port = view_port;
     view_port_draw_callback_set(view_port, render_callback, app);
     view_port_input_callback_set(view_port, input_callback, event_queue);
     
@@ -109,14 +589,16 @@ int32_t gb_cart_app(void* p) {
     
     // Configurar SPI
     FuriHalSpiBusHandle* spi = &furi_hal_spi_bus_handle_external;
-    const GpioPin* cs_pin1 = &gpio_ext_pa4;
     const GpioPin* cs_pin2 = &gpio_ext_pc3;
     
-    // Inicializar MCP23S17
+    // Inicializar MCP23S17 y el backend de direcciones
     app->mcp1 = malloc(sizeof(MCP23S17));
     app->mcp2 = malloc(sizeof(MCP23S17));
+    app->shift = malloc(sizeof(Shift595));
+    memset(app->mcp1, 0, sizeof(MCP23S17));
+    memset(app->shift, 0, sizeof(Shift595));
     
-    if (!mcp23s17_init(app->mcp1, 0, spi, cs_pin1) || 
+    if (!address_backend_select(app, GB_ADDRESS_DEFAULT_TYPE) || 
         !mcp23s17_init(app->mcp2, 1, spi, cs_pin2)) {
         FURI_LOG_E("MCP23S17", "Inicialización fallida");
         notification_message(notifications, &sequence_error);
@@ -125,7 +607,7 @@ int32_t gb_cart_app(void* p) {
         notification_message(notifications, &sequence_success);
         
         // Inicializar el lector de cartuchos
-        if (!gb_cart_init(app->mcp1, app->mcp2)) {
+        if (!gb_cart_init(&app->address, app->mcp2)) {
             FURI_LOG_E("GB_CART", "Inicialización fallida");
             notification_message(notifications, &sequence_error);
         }
@@ -136,17 +618,45 @@ int32_t gb_cart_app(void* p) {
     bool running = true;
     while (running) {
         if (furi_message_queue_get(event_queue, &event, 100) == FuriStatusOk) {
+            bool start_dump = false;
+            bool start_photos = false;
+            bool start_restore = false;
+            bool start_verify = false;
+            bool start_selftest = false;
+            bool stop_batch = false;
             furi_mutex_acquire(app->mutex, FuriWaitForever);
             
-            if (event.type == InputTypeShort) {
+            if (app->batch) {
+                // En modo por lotes el worker es dueño del bus: sólo se puede salir
+                if ((event.type == InputTypeLong && event.key == InputKeyOk) ||
+                    (event.type == InputTypeShort && event.key == InputKeyBack)) {
+                    stop_batch = true;
+                }
+            } else if (event.type == InputTypeShort) {
                 switch(event.key) {
                     case InputKeyBack:
                         running = false;
                         break;
                     case InputKeyOk:
-                        if (!app->reading) {
+                        if (!app->reading && app->gba_mode) {
+                            app->reading = true;
+                            app->cart_detected = gba_cart_read_info(&app->gba_info);
+                            if (app->cart_detected) {
+                                app->gba_save_type = GBA_SAVE_NONE;
+                                app->status[0] = '\0';
+                            }
+                            app->reading = false;
+                            notification_message(notifications,
+                                app->cart_detected ? &sequence_success : &sequence_error);
+                        } else if (!app->reading) {
                             app->reading = true;
                             app->cart_detected = gb_cart_read_info(&app->cart_info);
+                            if (app->cart_detected) {
+                                // Nuevo cartucho: el estado de bancos anterior ya no vale
+                                gb_mapper_init(&app->mapper, &app->cart_info);
+                                app->status[0] = '\0';
+                                app->verify_sampled_ok = false;
+                            }
                             app->reading = false;
                             
                             if (app->cart_detected) {
@@ -162,31 +672,127 @@ int32_t gb_cart_app(void* p) {
                         }
                         break;
                     case InputKeyDown:
-                        if (app->cart_detected && app->scroll_position < 50) {
+                        if (app->cart_detected && app->scroll_position < 110) {
                             app->scroll_position += 10;
                         }
                         break;
-                    case InputKeyLeft:
                     case InputKeyRight:
+                        if (app->cart_detected && !app->dumping) {
+                            start_dump = true;
+                        }
+                        break;
+                    case InputKeyLeft:
+                        if (app->cart_detected && !app->gba_mode && !app->dumping &&
+                            gb_camera_is_camera(&app->mapper)) {
+                            start_photos = true;
+                        }
+                        break;
                     case InputKeyMAX:
                         // Ignorar estas teclas
                         break;
                 }
+            } else if (event.type == InputTypeLong) {
+                switch(event.key) {
+                    case InputKeyOk:
+                        // Volcar cartuchos uno tras otro sin interacción
+                        if (app->gba_mode) break;
+                        app->batch = gb_batch_alloc(app->dump_format);
+                        app->cart_detected = false;
+                        gb_batch_start(app->batch);
+                        break;
+                    case InputKeyDown:
+                        // Autotest del bus: líneas atascadas o en corto
+                        if (!app->gba_mode && !app->dumping) {
+                            start_selftest = true;
+                        }
+                        break;
+                    case InputKeyUp:
+                        // Grabar la traza binaria del bus en trace.bin
+                        toggle_trace(app, notifications);
+                        break;
+                    case InputKeyBack:
+                        // Cambiar el hardware: direcciones (MCP1/595), RD/WR/CS (MCP2/GPIO
+                        // nativo) y, tras el último perfil, el modo GBA
+                        if (!app->dumping) {
+                            cycle_hardware(app, notifications);
+                        }
+                        break;
+                    case InputKeyRight:
+                        // Alternar entre volcado RAW y comprimido
+                        app->dump_format = (app->dump_format == GB_DUMP_FORMAT_RAW) ?
+                            GB_DUMP_FORMAT_GBZ : GB_DUMP_FORMAT_RAW;
+                        break;
+                    case InputKeyLeft:
+                        // GBA: escribir <titulo>.sav; GB: comparar con <titulo>.gb
+                        if (app->gba_mode && app->cart_detected && !app->dumping) {
+                            start_restore = true;
+                        } else if (app->cart_detected && !app->dumping) {
+                            start_verify = true;
+                        }
+                        break;
+                    default:
+                        break;
+                }
             }
             
             furi_mutex_release(app->mutex);
+            
+            // El volcado es largo: se hace sin el mutex para poder redibujar
+            if (start_dump && app->gba_mode) {
+                dump_gba(app, notifications);
+            } else if (start_dump) {
+                dump_rom(app, notifications);
+            }
+            if (start_restore) {
+                restore_gba_save(app, notifications);
+            }
+            if (start_verify) {
+                verify_rom(app, notifications);
+            }
+            if (start_selftest) {
+                run_selftest(app, notifications);
+            }
+            if (start_photos) {
+                extract_photos(app, notifications);
+            }
+            if (stop_batch) {
+                // El worker cancela el volcado en curso en el siguiente bloque;
+                // se libera más abajo cuando confirma que se ha detenido
+                gb_batch_stop(app->batch);
+                app->batch_stopping = true;
+            }
+        }
+        
+        if (app->batch_stopping) {
+            GBBatchStatus status;
+            gb_batch_get_status(app->batch, &status);
+            if (status.state == GB_BATCH_STOPPED) {
+                // Se quita de la pantalla antes de liberarlo
+                furi_mutex_acquire(app->mutex, FuriWaitForever);
+                GBBatch* batch = app->batch;
+                app->batch = NULL;
+                app->batch_stopping = false;
+                furi_mutex_release(app->mutex);
+                gb_batch_free(batch);
+                notification_message(notifications, &sequence_success);
+            }
         }
         
         view_port_update(view_port);
     }
     
     // Limpieza
+    if (app->trace_file) {
+        toggle_trace(app, notifications);
+    }
     view_port_enabled_set(view_port, false);
     gui_remove_view_port(gui, view_port);
     view_port_free(view_port);
     furi_message_queue_free(event_queue);
     furi_mutex_free(app->mutex);
     
+    // Pines nativos del cableado híbrido fuera antes de soltar los MCP
+    gb_cart_deinit();
     if (app->mcp1) {
         mcp23s17_deinit(app->mcp1);
         free(app->mcp1);
@@ -195,6 +801,10 @@ int32_t gb_cart_app(void* p) {
         mcp23s17_deinit(app->mcp2);
         free(app->mcp2);
     }
+    if (app->shift) {
+        shift_595_deinit(app->shift);
+        free(app->shift);
+    }
     
     free(app);
     
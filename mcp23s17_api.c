@@ -1,33 +1,63 @@
 #include "mcp23s17_api.h"
+#include <furi_hal_cortex.h>
 #include <string.h>
 
+// Estado de la traza (compartida por todos los MCP del bus). Pueden grabar
+// el hilo de la interfaz y el del modo por lotes: el estado se protege con
+// 'mutex', salvo un buffer marcado 'full', que es del hilo escritor hasta que
+// lo vuelca y baja la marca
+static struct {
+    volatile bool active;
+    FuriMutex* mutex;
+    FuriSemaphore* ready;          // Al escritor: hay un buffer lleno (o fin)
+    FuriSemaphore* done;           // Del escritor: ha vaciado un buffer
+    FuriThread* writer;
+    MCP23S17TraceFrame* buffers[2];
+    uint16_t count[2];
+    volatile bool full[2];         // Pendiente de volcar por el escritor
+    uint8_t recording;             // Buffer en el que se graba
+    uint32_t stalled;    // Ciclos esperando al escritor, descontados de los timestamps
+    uint32_t dropped;    // Tramas perdidas por error de escritura
+    MCP23S17TraceWriteCallback write;
+    void* context;
+} mcp23s17_trace;
+
 // SPI write con CS control
 bool mcp23s17_spi_write(MCP23S17* mcp, uint8_t* data, size_t size) {
+    uint32_t timestamp = mcp23s17_trace.active ? mcp23s17_trace_timestamp() : 0;
     furi_hal_spi_acquire(mcp->spi);
     furi_hal_gpio_write(mcp->cs_pin, false);
-    bool result = furi_hal_spi_bus_tx(mcp->spi, data, size, 100);
+    bool result = furi_hal_spi_bus_tx(mcp->spi, data, size, MCP23S17_SPI_TIMEOUT);
     furi_hal_gpio_write(mcp->cs_pin, true);
     furi_hal_spi_release(mcp->spi);
+    if(mcp23s17_trace.active && size >= 2) {
+        mcp23s17_trace_record(timestamp, mcp->address, data[0], data[1], &data[2], size - 2);
+    }
     return result;
 }
 
 // SPI read con CS control
 bool mcp23s17_spi_read(MCP23S17* mcp, uint8_t* tx_data, size_t tx_size, uint8_t* rx_data, size_t rx_size) {
+    uint32_t timestamp = mcp23s17_trace.active ? mcp23s17_trace_timestamp() : 0;
     furi_hal_spi_acquire(mcp->spi);
     furi_hal_gpio_write(mcp->cs_pin, false);
     
     // Transmitir datos
-    bool tx_result = furi_hal_spi_bus_tx(mcp->spi, tx_data, tx_size, 100);
+    bool tx_result = furi_hal_spi_bus_tx(mcp->spi, tx_data, tx_size, MCP23S17_SPI_TIMEOUT);
     
     // Recibir datos
     bool rx_result = false;
     if(tx_result) {
-        rx_result = furi_hal_spi_bus_rx(mcp->spi, rx_data, rx_size, 100);
+        rx_result = furi_hal_spi_bus_rx(mcp->spi, rx_data, rx_size, MCP23S17_SPI_TIMEOUT);
     }
     
     furi_hal_gpio_write(mcp->cs_pin, true);
     furi_hal_spi_release(mcp->spi);
     
+    if(mcp23s17_trace.active && tx_size >= 2) {
+        mcp23s17_trace_record(timestamp, mcp->address, tx_data[0], tx_data[1], rx_data, rx_size);
+    }
+    
     return tx_result && rx_result;
 }
 
@@ -214,6 +244,77 @@ bool mcp23s17_write_port(MCP23S17* mcp, MCP23S17Port port, uint8_t value) {
     return true;
 }
 
+// Escribe los dos puertos en una sola trama (OLATA y OLATB son consecutivos
+// con IOCON.BANK = 0 y el direccionamiento secuencial activo). No verifica
+// leyendo GPIO: pensado para el camino rápido de lectura del cartucho
+bool mcp23s17_write_ports(MCP23S17* mcp, uint8_t value_a, uint8_t value_b) {
+    if(!mcp || !mcp->initialized) return false;
+    
+    uint8_t buffer[4] = {
+        MCP23S17_WRITE_OPCODE | (mcp->address << 1),
+        MCP23S17_OLATA,
+        value_a,
+        value_b
+    };
+    
+    bool result = mcp23s17_spi_write(mcp, buffer, sizeof(buffer));
+    if(result) {
+        mcp->reg_cache[MCP23S17_OLATA] = value_a;
+        mcp->reg_cache[MCP23S17_OLATB] = value_b;
+    }
+    
+    return result;
+}
+
+// Escribe un registro sólo si cambia respecto a la cache (que se actualiza en
+// cada escritura). Sin lectura de vuelta: para el camino rápido del cartucho
+bool mcp23s17_update_reg(MCP23S17* mcp, uint8_t reg, uint8_t value) {
+    if(!mcp || !mcp->initialized || reg >= sizeof(mcp->reg_cache)) return false;
+    if(mcp->reg_cache[reg] == value) return true;
+    return mcp23s17_write_reg(mcp, reg, value);
+}
+
+// Cambia los pines de 'mask' de un puerto de salida a los de 'value' partiendo
+// del OLAT en cache: como mucho una trama, en vez de leer OLAT antes y GPIO
+// después como mcp23s17_digital_write
+bool mcp23s17_update_pins(MCP23S17* mcp, MCP23S17Port port, uint8_t mask, uint8_t value) {
+    if(!mcp || !mcp->initialized) return false;
+    uint8_t olat_reg = (port == MCP23S17_PORT_A) ? MCP23S17_OLATA : MCP23S17_OLATB;
+    return mcp23s17_update_reg(mcp, olat_reg, (mcp->reg_cache[olat_reg] & ~mask) | (value & mask));
+}
+
+// Escribe varios registros consecutivos en una sola trama (direccionamiento
+// secuencial, IOCON.SEQOP = 0). Máximo 4 registros para que quepan en la traza
+bool mcp23s17_write_regs(MCP23S17* mcp, uint8_t reg, const uint8_t* values, size_t count) {
+    if(!mcp || !mcp->initialized || !values || count == 0 || count > MCP23S17_TRACE_MAX_DATA) return false;
+    
+    uint8_t buffer[2 + MCP23S17_TRACE_MAX_DATA];
+    buffer[0] = MCP23S17_WRITE_OPCODE | (mcp->address << 1);
+    buffer[1] = reg;
+    memcpy(&buffer[2], values, count);
+    
+    bool result = mcp23s17_spi_write(mcp, buffer, 2 + count);
+    if(result) {
+        for(size_t i = 0; i < count && reg + i < sizeof(mcp->reg_cache); i++) {
+            mcp->reg_cache[reg + i] = values[i];
+        }
+    }
+    
+    return result;
+}
+
+// Lee varios registros consecutivos en una sola trama
+bool mcp23s17_read_regs(MCP23S17* mcp, uint8_t reg, uint8_t* values, size_t count) {
+    if(!mcp || !mcp->initialized || !values || count == 0) return false;
+    
+    uint8_t tx_buf[2] = {
+        MCP23S17_READ_OPCODE | (mcp->address << 1),
+        reg
+    };
+    
+    return mcp23s17_spi_read(mcp, tx_buf, sizeof(tx_buf), values, count);
+}
+
 // Lee un pin individual
 bool mcp23s17_digital_read(MCP23S17* mcp, uint8_t pin, MCP23S17Port port, bool* value) {
     if(!mcp || !mcp->initialized || pin > 7 || !value) return false;
@@ -241,10 +342,15 @@ bool mcp23s17_read_port(MCP23S17* mcp, MCP23S17Port port, uint8_t* value) {
 bool mcp23s17_is_connected(MCP23S17* mcp) {
     if(!mcp) return false;
     
-    uint8_t test_val;
-    bool result = mcp23s17_read_reg(mcp, MCP23S17_IODIRA, &test_val);
-    
-    return result;
+    // Con MISO al aire la lectura "funciona" pero devuelve 0x00 o 0xFF: se
+    // compara IOCON con el valor que escribió mcp23s17_init
+    uint8_t iocon;
+    if(!mcp23s17_read_reg(mcp, MCP23S17_IOCONA, &iocon)) return false;
+    if(iocon != IOCON_HAEN) {
+        FURI_LOG_W("MCP23S17", "IOCON leído 0x%02X, esperado 0x%02X", iocon, IOCON_HAEN);
+        return false;
+    }
+    return true;
 }
 
 // Función para desinicializar el MCP23S17
@@ -262,4 +368,141 @@ void mcp23s17_deinit(MCP23S17* mcp) {
     mcp->spi = NULL;
     mcp->cs_pin = NULL;
     memset(mcp->reg_cache, 0, sizeof(mcp->reg_cache));
-} 
\ No newline at end of file
+} 
+
+// Timestamp de la traza: contador de ciclos de la CPU (DWT)
+uint32_t mcp23s17_trace_timestamp(void) {
+    return furi_hal_cortex_timer_get(0).start;
+}
+
+// Vuelca un buffer completo a través del callback. Sólo lo llama el hilo
+// escritor o mcp23s17_trace_stop con el escritor ya terminado
+static void mcp23s17_trace_write_buffer(uint8_t index) {
+    uint16_t count = mcp23s17_trace.count[index];
+    if(count > 0 && !mcp23s17_trace.write(
+                        (const uint8_t*)mcp23s17_trace.buffers[index],
+                        count * sizeof(MCP23S17TraceFrame),
+                        mcp23s17_trace.context)) {
+        mcp23s17_trace.dropped += count;
+    }
+    mcp23s17_trace.count[index] = 0;
+}
+
+// Hilo escritor: vuelca cada buffer lleno y termina cuando se para la traza
+static int32_t mcp23s17_trace_writer(void* context) {
+    UNUSED(context);
+    while(true) {
+        furi_semaphore_acquire(mcp23s17_trace.ready, FuriWaitForever);
+        for(uint8_t i = 0; i < 2; i++) {
+            if(!mcp23s17_trace.full[i]) continue;
+            mcp23s17_trace_write_buffer(i);
+            mcp23s17_trace.full[i] = false;
+            furi_semaphore_release(mcp23s17_trace.done);
+        }
+        if(!mcp23s17_trace.active) break;
+    }
+    return 0;
+}
+
+// Empieza a grabar la traza. Escribe la cabecera, reserva los dos buffers y
+// arranca el hilo escritor
+bool mcp23s17_trace_start(MCP23S17TraceWriteCallback write, void* context) {
+    if(mcp23s17_trace.active || !write) return false;
+
+    MCP23S17TraceHeader header = {
+        .magic = MCP23S17_TRACE_MAGIC,
+        .version = MCP23S17_TRACE_VERSION,
+        .frame_size = sizeof(MCP23S17TraceFrame),
+        .cycles_per_us = furi_hal_cortex_instructions_per_microsecond(),
+    };
+    if(!write((const uint8_t*)&header, sizeof(header), context)) return false;
+
+    for(uint8_t i = 0; i < 2; i++) {
+        mcp23s17_trace.buffers[i] = malloc(MCP23S17_TRACE_BUFFER_FRAMES * sizeof(MCP23S17TraceFrame));
+        mcp23s17_trace.count[i] = 0;
+        mcp23s17_trace.full[i] = false;
+    }
+    mcp23s17_trace.recording = 0;
+    mcp23s17_trace.stalled = 0;
+    mcp23s17_trace.dropped = 0;
+    mcp23s17_trace.write = write;
+    mcp23s17_trace.context = context;
+    mcp23s17_trace.mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    mcp23s17_trace.ready = furi_semaphore_alloc(2, 0);
+    mcp23s17_trace.done = furi_semaphore_alloc(2, 0);
+    mcp23s17_trace.writer = furi_thread_alloc_ex("MCPTraceWriter", 1024, mcp23s17_trace_writer, NULL);
+    mcp23s17_trace.active = true;
+    furi_thread_start(mcp23s17_trace.writer);
+    return true;
+}
+
+// Guarda una trama en el buffer activo. Sin formateo de texto ni escritura:
+// al llenarse se pasa al otro buffer y se avisa al hilo escritor. Si el otro
+// aún no se ha volcado se espera aquí, ya fuera de la operación medida, y esa
+// espera se descuenta de los timestamps siguientes
+void mcp23s17_trace_record(uint32_t timestamp, uint8_t chip, uint8_t opcode, uint8_t reg, const uint8_t* data, size_t length) {
+    if(!mcp23s17_trace.active) return;
+    furi_mutex_acquire(mcp23s17_trace.mutex, FuriWaitForever);
+    if(!mcp23s17_trace.active) {
+        // Se paró la traza mientras se esperaba el mutex
+        furi_mutex_release(mcp23s17_trace.mutex);
+        return;
+    }
+
+    uint8_t index = mcp23s17_trace.recording;
+    MCP23S17TraceFrame* frame = &mcp23s17_trace.buffers[index][mcp23s17_trace.count[index]];
+    frame->timestamp = timestamp - mcp23s17_trace.stalled;
+    frame->chip = chip;
+    frame->opcode = opcode;
+    frame->reg = reg;
+    frame->length = (length > MCP23S17_TRACE_MAX_DATA) ? MCP23S17_TRACE_MAX_DATA : length;
+    memcpy(frame->data, data, frame->length);
+
+    if(++mcp23s17_trace.count[index] == MCP23S17_TRACE_BUFFER_FRAMES) {
+        if(mcp23s17_trace.full[index ^ 1]) {
+            uint32_t start = mcp23s17_trace_timestamp();
+            while(mcp23s17_trace.full[index ^ 1]) {
+                furi_semaphore_acquire(mcp23s17_trace.done, FuriWaitForever);
+            }
+            mcp23s17_trace.stalled += mcp23s17_trace_timestamp() - start;
+        }
+        mcp23s17_trace.full[index] = true;
+        mcp23s17_trace.recording = index ^ 1;
+        furi_semaphore_release(mcp23s17_trace.ready);
+    }
+    furi_mutex_release(mcp23s17_trace.mutex);
+}
+
+// Termina la traza: para el hilo escritor y vuelca lo que quede, primero el
+// buffer lleno pendiente (más antiguo) y después el que se estaba grabando
+void mcp23s17_trace_stop(void) {
+    if(!mcp23s17_trace.active) return;
+    furi_mutex_acquire(mcp23s17_trace.mutex, FuriWaitForever);
+    mcp23s17_trace.active = false;
+    furi_mutex_release(mcp23s17_trace.mutex);
+    furi_semaphore_release(mcp23s17_trace.ready);
+    furi_thread_join(mcp23s17_trace.writer);
+    furi_thread_free(mcp23s17_trace.writer);
+
+    uint8_t index = mcp23s17_trace.recording;
+    if(mcp23s17_trace.full[index ^ 1]) mcp23s17_trace_write_buffer(index ^ 1);
+    mcp23s17_trace_write_buffer(index);
+
+    for(uint8_t i = 0; i < 2; i++) {
+        free(mcp23s17_trace.buffers[i]);
+        mcp23s17_trace.buffers[i] = NULL;
+        mcp23s17_trace.full[i] = false;
+    }
+    furi_semaphore_free(mcp23s17_trace.done);
+    furi_semaphore_free(mcp23s17_trace.ready);
+    furi_mutex_free(mcp23s17_trace.mutex);
+    FURI_LOG_I("MCP23S17", "Traza terminada, tramas perdidas: %lu", mcp23s17_trace.dropped);
+}
+
+bool mcp23s17_trace_is_active(void) {
+    return mcp23s17_trace.active;
+}
+
+uint32_t mcp23s17_trace_dropped(void) {
+    return mcp23s17_trace.dropped;
+}
@@ -58,6 +58,10 @@
 #define OPCODER       (0b01000001)  // Opcode for MCP23S17 with LSB (bit0) set to read (1), address OR'd in later, bits 1-3
 #define ADDR_ENABLE   (0b00001000)  // Configuration register for MCP23S17, the only thing we change is enabling hardware addressing
 
+// Timeout de cada transferencia SPI (ms). Una transferencia dura microsegundos,
+// así que un valor bajo evita que un fallo del bus bloquee las operaciones largas
+#define MCP23S17_SPI_TIMEOUT 5
+
 // Opcode para SPI
 #define MCP23S17_WRITE_OPCODE 0x40
 #define MCP23S17_READ_OPCODE  0x41
@@ -73,6 +77,39 @@ typedef enum {
     MCP23S17_PIN_MODE_INPUT_PULLUP = 2
 } MCP23S17PinMode;
 
+// Traza binaria del bus: cada trama SPI se guarda en uno de dos buffers en RAM.
+// Cuando uno se llena, un hilo propio lo vuelca a través de un callback
+// (normalmente a la SD) mientras se sigue grabando en el otro, así la
+// escritura no cae dentro de las operaciones que se miden.
+// Formato del archivo: MCP23S17TraceHeader seguido de MCP23S17TraceFrame
+#define MCP23S17_TRACE_MAGIC        "MCPT"
+#define MCP23S17_TRACE_VERSION      1
+#define MCP23S17_TRACE_BUFFER_FRAMES 256  // Tramas por buffer (hay dos)
+#define MCP23S17_TRACE_MAX_DATA     4
+
+// Valores especiales del campo chip para eventos que no son de un MCP23S17
+#define MCP23S17_TRACE_CHIP_GPIO    0xFE  // Pin nativo del Flipper (reg = pin, data[0] = nivel)
+#define MCP23S17_TRACE_CHIP_SHIFT_595 0xFD // Cadena 74HC595 (data = bytes desplazados)
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint8_t version;
+    uint8_t frame_size;
+    uint16_t cycles_per_us;  // Para convertir timestamps a microsegundos
+} MCP23S17TraceHeader;
+
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp;  // Ciclos de CPU al empezar la trama
+    uint8_t chip;        // Dirección hardware del MCP (o MCP23S17_TRACE_CHIP_*)
+    uint8_t opcode;      // Opcode SPI (bit 0 = lectura)
+    uint8_t reg;         // Registro
+    uint8_t length;      // Bytes de datos escritos o leídos
+    uint8_t data[MCP23S17_TRACE_MAX_DATA];
+} MCP23S17TraceFrame;
+
+// Destino de la traza
+typedef bool (*MCP23S17TraceWriteCallback)(const uint8_t* data, size_t size, void* context);
+
 typedef struct {
     uint8_t address;      // Dirección SPI del dispositivo (0-7)
     uint8_t reg_cache[22]; // Cache de valores de registros
@@ -91,8 +128,21 @@ bool mcp23s17_port_mode(MCP23S17* mcp, MCP23S17Port port, uint8_t mode);
 bool mcp23s17_digital_write(MCP23S17* mcp, uint8_t pin, MCP23S17Port port, bool value);
 bool mcp23s17_digital_read(MCP23S17* mcp, uint8_t pin, MCP23S17Port port, bool* value);
 bool mcp23s17_write_port(MCP23S17* mcp, MCP23S17Port port, uint8_t value);
+bool mcp23s17_write_ports(MCP23S17* mcp, uint8_t value_a, uint8_t value_b);
+bool mcp23s17_write_regs(MCP23S17* mcp, uint8_t reg, const uint8_t* values, size_t count);
+bool mcp23s17_update_reg(MCP23S17* mcp, uint8_t reg, uint8_t value);
+bool mcp23s17_update_pins(MCP23S17* mcp, MCP23S17Port port, uint8_t mask, uint8_t value);
+bool mcp23s17_read_regs(MCP23S17* mcp, uint8_t reg, uint8_t* values, size_t count);
 bool mcp23s17_read_port(MCP23S17* mcp, MCP23S17Port port, uint8_t* value);
 bool mcp23s17_is_connected(MCP23S17* mcp);
 void mcp23s17_deinit(MCP23S17* mcp);
 
+// Traza del bus
+bool mcp23s17_trace_start(MCP23S17TraceWriteCallback write, void* context);
+void mcp23s17_trace_stop(void);
+bool mcp23s17_trace_is_active(void);
+void mcp23s17_trace_record(uint32_t timestamp, uint8_t chip, uint8_t opcode, uint8_t reg, const uint8_t* data, size_t length);
+uint32_t mcp23s17_trace_timestamp(void);
+uint32_t mcp23s17_trace_dropped(void);
+
 #endif // MCP23S17_API_H 
@@ -0,0 +1,48 @@
+#include "shift_595.h"
+#include "mcp23s17_api.h"
+
+// Inicializa la cadena de 74HC595
+bool shift_595_init(Shift595* chain, FuriHalSpiBusHandle* spi, const GpioPin* latch_pin, uint8_t length) {
+    if(!chain || !spi || !latch_pin || length == 0 || length > SHIFT_595_MAX_CHAIN) return false;
+    
+    chain->spi = spi;
+    chain->latch_pin = latch_pin;
+    chain->length = length;
+    
+    // El latch queda alto en reposo: la transferencia lo baja y al subir
+    // copia los registros de desplazamiento a las salidas
+    furi_hal_gpio_write(chain->latch_pin, true);
+    furi_hal_gpio_init_simple(chain->latch_pin, GpioModeOutputPushPull);
+    
+    chain->initialized = true;
+    return true;
+}
+
+// Desplaza 'length' bytes y los pasa a las salidas con un pulso de latch
+bool shift_595_write(Shift595* chain, const uint8_t* data) {
+    if(!chain || !chain->initialized || !data) return false;
+    
+    uint32_t timestamp = mcp23s17_trace_is_active() ? mcp23s17_trace_timestamp() : 0;
+    furi_hal_spi_acquire(chain->spi);
+    furi_hal_gpio_write(chain->latch_pin, false);
+    bool result = furi_hal_spi_bus_tx(chain->spi, data, chain->length, MCP23S17_SPI_TIMEOUT);
+    furi_hal_gpio_write(chain->latch_pin, true);
+    furi_hal_spi_release(chain->spi);
+    
+    if(mcp23s17_trace_is_active()) {
+        mcp23s17_trace_record(timestamp, MCP23S17_TRACE_CHIP_SHIFT_595, 0, 0, data, chain->length);
+    }
+    return result;
+}
+
+// Libera el pin de latch
+void shift_595_deinit(Shift595* chain) {
+    if(!chain) return;
+    
+    if(chain->latch_pin) {
+        furi_hal_gpio_init_simple(chain->latch_pin, GpioModeAnalog);
+    }
+    chain->initialized = false;
+    chain->spi = NULL;
+    chain->latch_pin = NULL;
+}
@@ -0,0 +1,29 @@
+#ifndef SHIFT_595_H
+#define SHIFT_595_H
+
+#include <furi.h>
+#include <furi_hal_spi.h>
+#include <furi_hal_gpio.h>
+
+// Cadena de registros de desplazamiento 74HC595 en el bus SPI.
+// SER del primero va a MOSI, QH' de cada uno a SER del siguiente, SRCLK a SCK
+// y RCLK (latch) a un pin propio. Los bytes se desplazan con MSB primero: el
+// último byte enviado queda en el primer 595 de la cadena. El resto del
+// tráfico SPI también entra en los registros, pero las salidas sólo cambian
+// con el flanco de subida del latch, justo después de nuestros bytes.
+
+#define SHIFT_595_MAX_CHAIN 4
+
+typedef struct {
+    FuriHalSpiBusHandle* spi;  // Handle SPI
+    const GpioPin* latch_pin;  // Pin RCLK
+    uint8_t length;            // Número de 595 en la cadena
+    bool initialized;          // Estado de inicialización
+} Shift595;
+
+// Declaraciones de funciones
+bool shift_595_init(Shift595* chain, FuriHalSpiBusHandle* spi, const GpioPin* latch_pin, uint8_t length);
+bool shift_595_write(Shift595* chain, const uint8_t* data);
+void shift_595_deinit(Shift595* chain);
+
+#endif // SHIFT_595_H
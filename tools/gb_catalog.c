@@ -0,0 +1,379 @@
+// Catálogo de volcados de Game Boy para el PC.
+//
+//   gcc -O2 -pthread -I. -o gb_catalog tools/gb_catalog.c gb_header.c
+//   ./gb_catalog volcados/ > catalogo.csv
+//   ./gb_catalog --json -j 8 volcados/ > catalogo.json
+//
+// Recorre el directorio (y sus subdirectorios) buscando .gb y .gbc, y los
+// procesa en paralelo con un hilo por núcleo: parsea el header con el mismo
+// código que la app (gb_header.c), verifica los checksums del header y
+// global, y calcula CRC32 y SHA-1. La salida sale en orden de ruta, sea cual
+// sea el orden en que terminan los hilos
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "gb_header.h"
+
+typedef struct {
+    char* path;
+    bool ok;                 // Archivo leído y con header
+    GBCartInfo info;
+    size_t file_size;
+    uint16_t global_checksum;
+    uint32_t crc32;
+    uint8_t sha1[20];
+} CatalogEntry;
+
+typedef struct {
+    CatalogEntry* entries;
+    size_t count;
+    size_t capacity;
+    atomic_size_t next;      // Siguiente entrada libre para los hilos
+} Catalog;
+
+// ---- CRC32 (polinomio 0xEDB88320, el de zip/No-Intro) ----
+
+static uint32_t crc32_table[256];
+
+static void crc32_init(void) {
+    for(uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for(int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+        crc32_table[i] = crc;
+    }
+}
+
+static uint32_t crc32_compute(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i = 0; i < length; i++) {
+        crc = crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+// ---- SHA-1 ----
+
+#define SHA1_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void sha1_block(uint32_t* state, const uint8_t* block) {
+    uint32_t w[80];
+    for(int i = 0; i < 16; i++) {
+        w[i] = (block[i * 4] << 24) | (block[i * 4 + 1] << 16) | (block[i * 4 + 2] << 8) |
+               block[i * 4 + 3];
+    }
+    for(int i = 16; i < 80; i++) {
+        w[i] = SHA1_ROTL(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for(int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if(i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if(i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if(i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = SHA1_ROTL(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = SHA1_ROTL(b, 30);
+        b = a;
+        a = temp;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+static void sha1_compute(const uint8_t* data, size_t length, uint8_t* digest) {
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    size_t full = length & ~(size_t)63;
+    for(size_t i = 0; i < full; i += 64) {
+        sha1_block(state, &data[i]);
+    }
+
+    // Último bloque: resto, 0x80, ceros y la longitud en bits (big endian)
+    uint8_t tail[128];
+    size_t rest = length - full;
+    memset(tail, 0, sizeof(tail));
+    memcpy(tail, &data[full], rest);
+    tail[rest] = 0x80;
+    size_t tail_length = (rest < 56) ? 64 : 128;
+    uint64_t bits = (uint64_t)length * 8;
+    for(int i = 0; i < 8; i++) {
+        tail[tail_length - 1 - i] = bits >> (i * 8);
+    }
+    for(size_t i = 0; i < tail_length; i += 64) {
+        sha1_block(state, &tail[i]);
+    }
+
+    for(int i = 0; i < 20; i++) {
+        digest[i] = state[i / 4] >> (24 - (i % 4) * 8);
+    }
+}
+
+// ---- Recorrido del directorio ----
+
+static bool has_rom_extension(const char* name) {
+    const char* dot = strrchr(name, '.');
+    return dot && (strcasecmp(dot, ".gb") == 0 || strcasecmp(dot, ".gbc") == 0);
+}
+
+static void catalog_add(Catalog* catalog, const char* path) {
+    if(catalog->count == catalog->capacity) {
+        catalog->capacity = catalog->capacity ? catalog->capacity * 2 : 64;
+        catalog->entries = realloc(catalog->entries, catalog->capacity * sizeof(CatalogEntry));
+    }
+    CatalogEntry* entry = &catalog->entries[catalog->count++];
+    memset(entry, 0, sizeof(CatalogEntry));
+    entry->path = strdup(path);
+}
+
+static void catalog_scan(Catalog* catalog, const char* directory) {
+    DIR* dir = opendir(directory);
+    if(!dir) {
+        fprintf(stderr, "No se pudo abrir %s\n", directory);
+        return;
+    }
+
+    struct dirent* item;
+    while((item = readdir(dir)) != NULL) {
+        if(item->d_name[0] == '.') continue;
+        size_t length = strlen(directory) + strlen(item->d_name) + 2;
+        char* path = malloc(length);
+        snprintf(path, length, "%s/%s", directory, item->d_name);
+
+        struct stat info;
+        if(stat(path, &info) == 0) {
+            if(S_ISDIR(info.st_mode)) {
+                catalog_scan(catalog, path);
+            } else if(S_ISREG(info.st_mode) && has_rom_extension(item->d_name)) {
+                catalog_add(catalog, path);
+            }
+        }
+        free(path);
+    }
+    closedir(dir);
+}
+
+static int catalog_compare(const void* a, const void* b) {
+    return strcmp(((const CatalogEntry*)a)->path, ((const CatalogEntry*)b)->path);
+}
+
+// ---- Procesado en paralelo ----
+
+static uint8_t* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = length > 0 ? malloc(length) : NULL;
+    if(data && fread(data, 1, length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+static void catalog_process(CatalogEntry* entry) {
+    uint8_t* data = read_file(entry->path, &entry->file_size);
+    if(!data) return;
+
+    entry->ok = gb_cart_parse_header(data, entry->file_size, &entry->info);
+    entry->global_checksum = gb_cart_global_checksum(data, entry->file_size);
+    entry->crc32 = crc32_compute(data, entry->file_size);
+    sha1_compute(data, entry->file_size, entry->sha1);
+    free(data);
+}
+
+// Cada hilo toma la siguiente entrada libre hasta que no quedan
+static void* catalog_worker(void* context) {
+    Catalog* catalog = context;
+    size_t index;
+    while((index = atomic_fetch_add(&catalog->next, 1)) < catalog->count) {
+        catalog_process(&catalog->entries[index]);
+    }
+    return NULL;
+}
+
+// ---- Salida ----
+
+static void print_sha1(FILE* out, const uint8_t* sha1) {
+    for(int i = 0; i < 20; i++) fprintf(out, "%02x", sha1[i]);
+}
+
+static void print_csv_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for(; *text; text++) {
+        if(*text == '"') fputc('"', out);
+        fputc(*text, out);
+    }
+    fputc('"', out);
+}
+
+static void print_json_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for(; *text; text++) {
+        unsigned char c = *text;
+        if(c == '"' || c == '\\') {
+            fprintf(out, "\\%c", c);
+        } else if(c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static void print_csv(FILE* out, const Catalog* catalog) {
+    fprintf(out, "path,title,type,rom_kb,file_kb,ram_kb,gbc,sgb,battery,logo_ok,header_ok,"
+                 "global_ok,size_ok,crc32,sha1\n");
+    for(size_t i = 0; i < catalog->count; i++) {
+        const CatalogEntry* entry = &catalog->entries[i];
+        char type[32];
+        gb_cart_get_type_string(type, entry->info.cart_type);
+
+        print_csv_string(out, entry->path);
+        fputc(',', out);
+        print_csv_string(out, entry->ok ? entry->info.title : "");
+        fprintf(
+            out,
+            ",%s,%lu,%zu,%lu,%d,%d,%d,%d,%d,%d,%d,%08x,",
+            entry->ok ? type : "",
+            (unsigned long)entry->info.rom_size / 1024,
+            entry->file_size / 1024,
+            (unsigned long)entry->info.ram_size / 1024,
+            entry->info.is_gbc,
+            entry->info.has_sgb,
+            entry->info.has_battery,
+            entry->info.logo_ok,
+            entry->info.header_checksum_ok,
+            entry->ok && entry->global_checksum == entry->info.global_checksum,
+            entry->ok && entry->file_size == entry->info.rom_size,
+            entry->crc32);
+        print_sha1(out, entry->sha1);
+        fputc('\n', out);
+    }
+}
+
+static void print_json(FILE* out, const Catalog* catalog) {
+    fprintf(out, "[\n");
+    for(size_t i = 0; i < catalog->count; i++) {
+        const CatalogEntry* entry = &catalog->entries[i];
+        char type[32];
+        gb_cart_get_type_string(type, entry->info.cart_type);
+
+        fprintf(out, "  {\"path\": ");
+        print_json_string(out, entry->path);
+        fprintf(out, ", \"valid\": %s", entry->ok ? "true" : "false");
+        if(entry->ok) {
+            fprintf(out, ", \"title\": ");
+            print_json_string(out, entry->info.title);
+            fprintf(
+                out,
+                ", \"type\": \"%s\", \"cart_type\": %u, \"rom_size\": %lu, \"ram_size\": %lu, "
+                "\"gbc\": %s, \"sgb\": %s, \"battery\": %s, \"logo_ok\": %s, "
+                "\"header_checksum_ok\": %s, \"global_checksum\": \"%04x\", "
+                "\"global_checksum_ok\": %s, \"size_ok\": %s",
+                type,
+                entry->info.cart_type,
+                (unsigned long)entry->info.rom_size,
+                (unsigned long)entry->info.ram_size,
+                entry->info.is_gbc ? "true" : "false",
+                entry->info.has_sgb ? "true" : "false",
+                entry->info.has_battery ? "true" : "false",
+                entry->info.logo_ok ? "true" : "false",
+                entry->info.header_checksum_ok ? "true" : "false",
+                entry->info.global_checksum,
+                entry->global_checksum == entry->info.global_checksum ? "true" : "false",
+                entry->file_size == entry->info.rom_size ? "true" : "false");
+        }
+        fprintf(out, ", \"file_size\": %zu, \"crc32\": \"%08x\", \"sha1\": \"", entry->file_size, entry->crc32);
+        print_sha1(out, entry->sha1);
+        fprintf(out, "\"}%s\n", i + 1 < catalog->count ? "," : "");
+    }
+    fprintf(out, "]\n");
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char* directory = NULL;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if(strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atol(argv[++i]);
+        } else if(!directory) {
+            directory = argv[i];
+        } else {
+            directory = NULL;
+            break;
+        }
+    }
+    if(!directory) {
+        fprintf(stderr, "Uso: %s [--json] [-j hilos] directorio\n", argv[0]);
+        return 1;
+    }
+    if(threads < 1) threads = 1;
+
+    Catalog catalog;
+    memset(&catalog, 0, sizeof(catalog));
+    crc32_init();
+    catalog_scan(&catalog, directory);
+    qsort(catalog.entries, catalog.count, sizeof(CatalogEntry), catalog_compare);
+    atomic_init(&catalog.next, 0);
+
+    if((size_t)threads > catalog.count) threads = catalog.count ? (long)catalog.count : 1;
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    for(long i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, catalog_worker, &catalog);
+    }
+    for(long i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    if(json) {
+        print_json(stdout, &catalog);
+    } else {
+        print_csv(stdout, &catalog);
+    }
+
+    size_t bad = 0;
+    for(size_t i = 0; i < catalog.count; i++) {
+        const CatalogEntry* entry = &catalog.entries[i];
+        if(!entry->ok || !entry->info.header_checksum_ok ||
+           entry->global_checksum != entry->info.global_checksum) {
+            bad++;
+        }
+        free(entry->path);
+    }
+    free(catalog.entries);
+    fprintf(stderr, "%zu ROMs, %zu con errores, %ld hilos\n", catalog.count, bad, threads);
+    return bad ? 2 : 0;
+}
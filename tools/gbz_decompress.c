@@ -0,0 +1,122 @@
+// Descompresor de volcados GBZ para el PC.
+//
+//   gcc -O2 -o gbz_decompress tools/gbz_decompress.c
+//   ./gbz_decompress TETRIS.gb.gbz [TETRIS.gb]
+//
+// Sin destino, se usa el nombre de entrada sin la extensión .gbz
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../gb_lz.h"
+
+static uint8_t* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = length > 0 ? malloc(length) : NULL;
+    if(data && fread(data, 1, length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+// Descomprime in[0..in_size) en out (de tamaño out_size). Devuelve false si
+// el flujo está corrupto
+static bool gbz_decode(const uint8_t* in, size_t in_size, uint8_t* out, size_t out_size) {
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+
+    while(out_pos < out_size) {
+        if(in_pos >= in_size) return false;
+        uint8_t flags = in[in_pos++];
+
+        for(int item = 0; item < 8 && out_pos < out_size; item++) {
+            if(flags & (1 << item)) {
+                if(in_pos >= in_size) return false;
+                out[out_pos++] = in[in_pos++];
+                continue;
+            }
+
+            if(in_pos + 2 > in_size) return false;
+            uint16_t token = in[in_pos] | (in[in_pos + 1] << 8);
+            in_pos += 2;
+            size_t distance = (token & GB_LZ_WINDOW_MASK) + 1;
+            size_t length = (token >> GB_LZ_WINDOW_BITS) + GB_LZ_MIN_MATCH;
+            if((token >> GB_LZ_WINDOW_BITS) == GB_LZ_LONG_CODE) {
+                if(in_pos >= in_size) return false;
+                length = GB_LZ_LONG_MATCH + in[in_pos++];
+            }
+            if(distance > out_pos || out_pos + length > out_size) return false;
+
+            // Copia byte a byte: la copia puede solaparse con lo que escribe
+            for(size_t i = 0; i < length; i++, out_pos++) {
+                out[out_pos] = out[out_pos - distance];
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2 || argc > 3) {
+        fprintf(stderr, "Uso: %s entrada.gbz [salida]\n", argv[0]);
+        return 1;
+    }
+
+    size_t in_size;
+    uint8_t* in = read_file(argv[1], &in_size);
+    if(!in || in_size < GB_LZ_MAGIC_SIZE + GB_LZ_FOOTER_SIZE ||
+       memcmp(in, GB_LZ_MAGIC, GB_LZ_MAGIC_SIZE) != 0) {
+        fprintf(stderr, "%s: no es un archivo GBZ\n", argv[1]);
+        free(in);
+        return 1;
+    }
+
+    const uint8_t* footer = &in[in_size - GB_LZ_FOOTER_SIZE];
+    size_t out_size = footer[0] | (footer[1] << 8) | (footer[2] << 16) | ((size_t)footer[3] << 24);
+    uint8_t* out = malloc(out_size ? out_size : 1);
+
+    const uint8_t* stream = &in[GB_LZ_MAGIC_SIZE];
+    size_t stream_size = in_size - GB_LZ_MAGIC_SIZE - GB_LZ_FOOTER_SIZE;
+    if(!out || !gbz_decode(stream, stream_size, out, out_size)) {
+        fprintf(stderr, "%s: datos corruptos\n", argv[1]);
+        free(in);
+        free(out);
+        return 1;
+    }
+
+    char out_path[4096];
+    if(argc == 3) {
+        snprintf(out_path, sizeof(out_path), "%s", argv[2]);
+    } else {
+        snprintf(out_path, sizeof(out_path), "%s", argv[1]);
+        size_t length = strlen(out_path);
+        if(length > 4 && strcmp(&out_path[length - 4], ".gbz") == 0) {
+            out_path[length - 4] = '\0';
+        } else {
+            snprintf(out_path, sizeof(out_path), "%s.bin", argv[1]);
+        }
+    }
+
+    FILE* file = fopen(out_path, "wb");
+    if(!file || fwrite(out, 1, out_size, file) != out_size) {
+        fprintf(stderr, "%s: no se pudo escribir\n", out_path);
+        if(file) fclose(file);
+        free(in);
+        free(out);
+        return 1;
+    }
+    fclose(file);
+
+    printf("%s: %zu -> %zu bytes\n", out_path, in_size, out_size);
+    free(in);
+    free(out);
+    return 0;
+}
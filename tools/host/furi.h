@@ -0,0 +1,45 @@
+// Sustituto mínimo de furi.h para compilar mcp23s17_api/gb_cart en Linux.
+// Sólo lo que usan esos módulos; el bus se emula en host_bus.c
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FURI_LOG_E(tag, ...) host_log('E', tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) host_log('W', tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) host_log('I', tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) host_log('D', tag, __VA_ARGS__)
+
+#define UNUSED(x) (void)(x)
+#define furi_assert(x) ((void)(x))
+#define FuriWaitForever 0xFFFFFFFFU
+
+void host_log(char level, const char* tag, const char* format, ...);
+void furi_delay_ms(uint32_t ms);
+void furi_delay_us(uint32_t us);
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t ms);
+
+// Hilos, mutex y semáforos (sobre pthreads) para el escritor de la traza
+typedef enum { FuriStatusOk = 0, FuriStatusError = -1 } FuriStatus;
+typedef enum { FuriMutexTypeNormal } FuriMutexType;
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriSemaphore FuriSemaphore;
+typedef struct FuriThread FuriThread;
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count);
+void furi_semaphore_free(FuriSemaphore* semaphore);
+FuriStatus furi_semaphore_acquire(FuriSemaphore* semaphore, uint32_t timeout);
+FuriStatus furi_semaphore_release(FuriSemaphore* semaphore);
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+void furi_thread_free(FuriThread* thread);
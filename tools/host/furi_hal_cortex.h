@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t start;
+    uint32_t value;
+} FuriHalCortexTimer;
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    const char* name;
+} GpioPin;
+
+typedef enum {
+    GpioModeInput,
+    GpioModeOutputPushPull,
+    GpioModeAnalog,
+} GpioMode;
+
+typedef enum {
+    GpioPullNo,
+    GpioPullUp,
+    GpioPullDown,
+} GpioPull;
+
+typedef enum {
+    GpioSpeedLow,
+    GpioSpeedVeryHigh,
+} GpioSpeed;
+
+extern const GpioPin gpio_ext_pa4;
+extern const GpioPin gpio_ext_pa6;
+extern const GpioPin gpio_ext_pa7;
+extern const GpioPin gpio_ext_pb2;
+extern const GpioPin gpio_ext_pb3;
+extern const GpioPin gpio_ext_pc0;
+extern const GpioPin gpio_ext_pc1;
+extern const GpioPin gpio_ext_pc3;
+
+void furi_hal_gpio_init_simple(const GpioPin* pin, GpioMode mode);
+void furi_hal_gpio_init(const GpioPin* pin, GpioMode mode, GpioPull pull, GpioSpeed speed);
+void furi_hal_gpio_write(const GpioPin* pin, bool state);
+bool furi_hal_gpio_read(const GpioPin* pin);
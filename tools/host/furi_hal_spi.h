@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    int id;
+} FuriHalSpiBusHandle;
+
+extern FuriHalSpiBusHandle furi_hal_spi_bus_handle_external;
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle);
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle);
+bool furi_hal_spi_bus_tx(FuriHalSpiBusHandle* handle, const uint8_t* buffer, size_t size, uint32_t timeout);
+bool furi_hal_spi_bus_rx(FuriHalSpiBusHandle* handle, uint8_t* buffer, size_t size, uint32_t timeout);
@@ -0,0 +1,215 @@
+#include "host_bus.h"
+#include <furi.h>
+#include <furi_hal_cortex.h>
+#include <stdarg.h>
+#include <pthread.h>
+
+const GpioPin gpio_ext_pa4 = {"PA4"};
+const GpioPin gpio_ext_pa6 = {"PA6"};
+const GpioPin gpio_ext_pa7 = {"PA7"};
+const GpioPin gpio_ext_pb2 = {"PB2"};
+const GpioPin gpio_ext_pb3 = {"PB3"};
+const GpioPin gpio_ext_pc0 = {"PC0"};
+const GpioPin gpio_ext_pc1 = {"PC1"};
+const GpioPin gpio_ext_pc3 = {"PC3"};
+
+FuriHalSpiBusHandle furi_hal_spi_bus_handle_external = {0};
+
+static HostBus host_bus;
+static bool host_log_enabled = false;
+static uint32_t host_cycles = 0;
+
+void host_bus_set(const HostBus* bus) {
+    host_bus = *bus;
+}
+
+void host_log_set_enabled(bool enabled) {
+    host_log_enabled = enabled;
+}
+
+void host_log(char level, const char* tag, const char* format, ...) {
+    if(!host_log_enabled) return;
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[%c][%s] ", level, tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+void furi_delay_ms(uint32_t ms) {
+    host_cycles += ms * 64000;
+}
+
+void furi_delay_us(uint32_t us) {
+    host_cycles += us * 64;
+}
+
+uint32_t furi_get_tick(void) {
+    return host_cycles / 64000;
+}
+
+uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    FuriHalCortexTimer timer = {host_cycles, timeout_us * 64};
+    return timer;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return 64;
+}
+
+void furi_hal_gpio_init_simple(const GpioPin* pin, GpioMode mode) {
+    UNUSED(pin);
+    UNUSED(mode);
+}
+
+void furi_hal_gpio_init(const GpioPin* pin, GpioMode mode, GpioPull pull, GpioSpeed speed) {
+    UNUSED(pin);
+    UNUSED(mode);
+    UNUSED(pull);
+    UNUSED(speed);
+}
+
+void furi_hal_gpio_write(const GpioPin* pin, bool state) {
+    if(host_bus.gpio_write) host_bus.gpio_write(pin, state, host_bus.context);
+}
+
+bool furi_hal_gpio_read(const GpioPin* pin) {
+    return host_bus.gpio_read ? host_bus.gpio_read(pin, host_bus.context) : false;
+}
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle) {
+    UNUSED(handle);
+}
+
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle) {
+    UNUSED(handle);
+}
+
+// Cada byte a 8MHz cuesta ~1us: se avanza el reloj para que los timestamps
+// de las trazas grabadas en el host tengan sentido
+bool furi_hal_spi_bus_tx(FuriHalSpiBusHandle* handle, const uint8_t* buffer, size_t size, uint32_t timeout) {
+    UNUSED(handle);
+    UNUSED(timeout);
+    host_cycles += size * 64;
+    if(host_bus.spi_tx) host_bus.spi_tx(buffer, size, host_bus.context);
+    return true;
+}
+
+bool furi_hal_spi_bus_rx(FuriHalSpiBusHandle* handle, uint8_t* buffer, size_t size, uint32_t timeout) {
+    UNUSED(handle);
+    UNUSED(timeout);
+    host_cycles += size * 64;
+    if(host_bus.spi_rx) {
+        host_bus.spi_rx(buffer, size, host_bus.context);
+    } else {
+        for(size_t i = 0; i < size; i++) buffer[i] = 0xFF;
+    }
+    return true;
+}
+
+// Sólo se usan con FuriWaitForever: los timeouts no se implementan
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    UNUSED(type);
+    FuriMutex* mutex = malloc(sizeof(FuriMutex));
+    pthread_mutex_init(&mutex->mutex, NULL);
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    pthread_mutex_destroy(&mutex->mutex);
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    UNUSED(timeout);
+    return pthread_mutex_lock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    return pthread_mutex_unlock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+}
+
+struct FuriSemaphore {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t count;
+    uint32_t max_count;
+};
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count) {
+    FuriSemaphore* semaphore = malloc(sizeof(FuriSemaphore));
+    pthread_mutex_init(&semaphore->mutex, NULL);
+    pthread_cond_init(&semaphore->cond, NULL);
+    semaphore->count = initial_count;
+    semaphore->max_count = max_count;
+    return semaphore;
+}
+
+void furi_semaphore_free(FuriSemaphore* semaphore) {
+    pthread_cond_destroy(&semaphore->cond);
+    pthread_mutex_destroy(&semaphore->mutex);
+    free(semaphore);
+}
+
+FuriStatus furi_semaphore_acquire(FuriSemaphore* semaphore, uint32_t timeout) {
+    UNUSED(timeout);
+    pthread_mutex_lock(&semaphore->mutex);
+    while(semaphore->count == 0) pthread_cond_wait(&semaphore->cond, &semaphore->mutex);
+    semaphore->count--;
+    pthread_mutex_unlock(&semaphore->mutex);
+    return FuriStatusOk;
+}
+
+FuriStatus furi_semaphore_release(FuriSemaphore* semaphore) {
+    FuriStatus status = FuriStatusError;
+    pthread_mutex_lock(&semaphore->mutex);
+    if(semaphore->count < semaphore->max_count) {
+        semaphore->count++;
+        pthread_cond_signal(&semaphore->cond);
+        status = FuriStatusOk;
+    }
+    pthread_mutex_unlock(&semaphore->mutex);
+    return status;
+}
+
+struct FuriThread {
+    pthread_t thread;
+    FuriThreadCallback callback;
+    void* context;
+};
+
+static void* host_thread_entry(void* context) {
+    FuriThread* thread = context;
+    thread->callback(thread->context);
+    return NULL;
+}
+
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context) {
+    UNUSED(name);
+    UNUSED(stack_size);
+    FuriThread* thread = malloc(sizeof(FuriThread));
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    pthread_create(&thread->thread, NULL, host_thread_entry, thread);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    return pthread_join(thread->thread, NULL) == 0;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
@@ -0,0 +1,17 @@
+// Bus emulado para los builds de Linux: las llamadas furi_hal_spi/gpio de
+// mcp23s17_api y gb_cart se redirigen a estos callbacks
+#pragma once
+
+#include <furi_hal_gpio.h>
+#include <furi_hal_spi.h>
+
+typedef struct {
+    void (*gpio_write)(const GpioPin* pin, bool state, void* context);
+    bool (*gpio_read)(const GpioPin* pin, void* context);
+    void (*spi_tx)(const uint8_t* data, size_t size, void* context);
+    void (*spi_rx)(uint8_t* data, size_t size, void* context);
+    void* context;
+} HostBus;
+
+void host_bus_set(const HostBus* bus);
+void host_log_set_enabled(bool enabled);
@@ -0,0 +1,563 @@
+// Reproduce en el PC una traza binaria del bus grabada en el Flipper
+// (trace.bin, ver mcp23s17_trace_start) y la compara con el código actual.
+//
+//   gcc -O2 -pthread -Itools/host -I. -o mcp_replay tools/mcp_replay.c
+//       tools/host/host_bus.c mcp23s17_api.c shift_595.c gb_address.c gb_cart.c gb_header.c
+//   (en una sola línea)
+//   ./mcp_replay trace.bin [otra_traza.bin]
+//   ./mcp_replay --synth salida.bin [--hybrid] [--595]   (traza sintética con el código actual)
+//
+// Pasos:
+//  1. Decodifica las tramas con un modelo de los dos MCP23S17 (o de los 595)
+//     y del bus del
+//     cartucho para recuperar las operaciones lógicas (lecturas y escrituras
+//     del cartucho) con sus direcciones y datos.
+//  2. Ejecuta esas mismas operaciones con mcp23s17_api/gb_cart compilados
+//     para Linux sobre el bus emulado, comprobando que cada lectura y
+//     escritura llega al cartucho con la dirección y el dato correctos.
+//  3. Muestra tramas, bytes SPI y tiempos de la traza y del código actual.
+//     Con dos trazas muestra también la diferencia entre ambas.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <furi.h>
+#include "host_bus.h"
+#include "mcp23s17_api.h"
+#include "gb_cart.h"
+
+// Direcciones hardware de los MCP (igual que en main.c)
+#define REPLAY_MCP1_ADDRESS 0
+#define REPLAY_MCP2_ADDRESS 1
+
+// Señales de control en el puerto A del MCP2 (ver gb_cart.c)
+#define REPLAY_WR_BIT (1 << 1)
+#define REPLAY_RD_BIT (1 << 2)
+#define REPLAY_IDLE_CONTROL 0x27 // CLK, WR, RD y RST altos
+
+#define REPLAY_REG_COUNT 0x16
+
+typedef struct {
+    uint8_t regs[REPLAY_REG_COUNT];
+    uint8_t pointer;
+    uint8_t opcode;
+    size_t byte_index;
+    uint8_t address;
+} McpModel;
+
+typedef enum {
+    OP_READ,
+    OP_WRITE,
+} OpType;
+
+typedef struct {
+    OpType type;
+    uint16_t address;
+    uint8_t value;
+} LogicalOp;
+
+// Bus del cartucho: dos MCP y las señales que ve el cartucho
+typedef struct {
+    McpModel mcp[2];
+    McpModel* selected;
+    bool last_wr;
+    // Pines nativos del cableado híbrido (activos en bajo, reposo = alto)
+    bool native_rd;
+    bool native_wr;
+    bool native_cs;
+    // Cadena 74HC595 en lugar del MCP1: todo el tráfico SPI entra en el
+    // registro de desplazamiento y el latch (PA4) lo pasa a A0-A15
+    bool shift_mode;
+    uint16_t shift_register;
+    uint16_t shift_address;
+    // Ejecución en vivo
+    uint8_t next_read_value;
+    bool read_seen;
+    uint16_t read_address;
+    bool write_seen;
+    uint16_t write_address;
+    uint8_t write_value;
+    uint32_t frames;
+    uint32_t spi_bytes;
+} CartBus;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t reads_frames;
+    uint32_t writes_frames;
+    uint32_t spi_bytes;
+    uint32_t gpio_frames;     // Cambios de pines nativos (cableado híbrido)
+    uint32_t shift_frames;    // Direcciones puestas con los 74HC595
+    uint64_t duration_cycles;
+    uint16_t cycles_per_us;
+    LogicalOp* ops;
+    size_t op_count;
+    size_t op_capacity;
+    uint32_t logical_reads;
+    uint32_t logical_writes;
+    // Código actual
+    uint32_t replay_frames;
+    uint32_t replay_spi_bytes;
+    uint32_t replay_mismatches;
+} TraceStats;
+
+static void mcp_model_reset(McpModel* mcp, uint8_t address) {
+    memset(mcp, 0, sizeof(McpModel));
+    mcp->regs[MCP23S17_IODIRA] = 0xFF;
+    mcp->regs[MCP23S17_IODIRB] = 0xFF;
+    mcp->address = address;
+}
+
+// Nivel de los pines de un puerto: salidas = OLAT, entradas = 'external'
+static uint8_t mcp_model_pins(const McpModel* mcp, int port, uint8_t external) {
+    uint8_t iodir = mcp->regs[MCP23S17_IODIRA + port];
+    uint8_t olat = mcp->regs[MCP23S17_OLATA + port];
+    return (olat & ~iodir) | (external & iodir);
+}
+
+// La traza empieza con el bus tal y como lo deja gb_cart_init: direcciones
+// como salidas, control en reposo (RD, WR, CLK y RST altos) y datos como entrada
+static void cart_bus_reset_idle(CartBus* bus) {
+    memset(bus, 0, sizeof(CartBus));
+    mcp_model_reset(&bus->mcp[0], REPLAY_MCP1_ADDRESS);
+    mcp_model_reset(&bus->mcp[1], REPLAY_MCP2_ADDRESS);
+    bus->mcp[0].regs[MCP23S17_IODIRA] = 0x00;
+    bus->mcp[0].regs[MCP23S17_IODIRB] = 0x00;
+    bus->mcp[1].regs[MCP23S17_IODIRA] = 0x00;
+    bus->mcp[1].regs[MCP23S17_OLATA] = REPLAY_IDLE_CONTROL;
+    bus->last_wr = true;
+    bus->native_rd = true;
+    bus->native_wr = true;
+    bus->native_cs = true;
+}
+
+static uint16_t cart_bus_address(const CartBus* bus) {
+    if(bus->shift_mode) return bus->shift_address;
+    const McpModel* mcp1 = &bus->mcp[0];
+    return mcp_model_pins(mcp1, 0, 0xFF) | (mcp_model_pins(mcp1, 1, 0xFF) << 8);
+}
+
+static uint8_t cart_bus_control(const CartBus* bus) {
+    return mcp_model_pins(&bus->mcp[1], 0, 0xFF);
+}
+
+// RD y WR pueden venir del MCP2 o de los pines nativos: basta con que uno
+// de los dos esté activo (el otro queda en reposo según el cableado)
+static bool cart_bus_rd_active(const CartBus* bus) {
+    return !(cart_bus_control(bus) & REPLAY_RD_BIT) || !bus->native_rd;
+}
+
+// Se llama tras cada cambio de registro o pin: detecta el flanco de subida de WR
+static void cart_bus_update(CartBus* bus) {
+    bool wr = (cart_bus_control(bus) & REPLAY_WR_BIT) && bus->native_wr;
+    if(wr && !bus->last_wr) {
+        bus->write_seen = true;
+        bus->write_address = cart_bus_address(bus);
+        bus->write_value = mcp_model_pins(&bus->mcp[1], 1, 0xFF);
+    }
+    bus->last_wr = wr;
+}
+
+static void cart_bus_native(CartBus* bus, uint8_t trace_pin, bool level) {
+    switch(trace_pin) {
+    case GB_CART_TRACE_PIN_RD:
+        bus->native_rd = level;
+        break;
+    case GB_CART_TRACE_PIN_WR:
+        bus->native_wr = level;
+        break;
+    case GB_CART_TRACE_PIN_CS:
+        bus->native_cs = level;
+        break;
+    }
+    cart_bus_update(bus);
+}
+
+static void mcp_model_write(CartBus* bus, McpModel* mcp, uint8_t value) {
+    uint8_t reg = mcp->pointer;
+    if(reg < REPLAY_REG_COUNT) {
+        // Escribir GPIO equivale a escribir OLAT
+        if(reg == MCP23S17_GPIOA || reg == MCP23S17_GPIOB) reg += 2;
+        mcp->regs[reg] = value;
+    }
+    mcp->pointer = (mcp->pointer + 1) % REPLAY_REG_COUNT;
+    cart_bus_update(bus);
+}
+
+// Lectura en vivo: el dato del cartucho aparece en GPIOB del MCP2 con RD bajo
+static uint8_t mcp_model_read(CartBus* bus, McpModel* mcp) {
+    uint8_t reg = mcp->pointer;
+    uint8_t value = 0;
+    if(reg == MCP23S17_GPIOA || reg == MCP23S17_GPIOB) {
+        int port = reg - MCP23S17_GPIOA;
+        uint8_t external = 0xFF;
+        if(mcp == &bus->mcp[1] && port == 1 && cart_bus_rd_active(bus)) {
+            external = bus->next_read_value;
+            bus->read_seen = true;
+            bus->read_address = cart_bus_address(bus);
+        }
+        value = mcp_model_pins(mcp, port, external);
+    } else if(reg < REPLAY_REG_COUNT) {
+        value = mcp->regs[reg];
+    }
+    mcp->pointer = (mcp->pointer + 1) % REPLAY_REG_COUNT;
+    return value;
+}
+
+// ---- Bus emulado para la ejecución en vivo ----
+
+static void live_gpio_write(const GpioPin* pin, bool state, void* context) {
+    CartBus* bus = context;
+    if(pin == &gpio_ext_pc0) cart_bus_native(bus, GB_CART_TRACE_PIN_RD, state);
+    if(pin == &gpio_ext_pc1) cart_bus_native(bus, GB_CART_TRACE_PIN_WR, state);
+    if(pin == &gpio_ext_pb2) cart_bus_native(bus, GB_CART_TRACE_PIN_CS, state);
+
+    if(pin == &gpio_ext_pa4 && bus->shift_mode) {
+        // Flanco de subida del latch: el registro pasa a las salidas
+        if(state) {
+            bus->shift_address = bus->shift_register;
+            bus->frames++;
+            cart_bus_update(bus);
+        }
+        return;
+    }
+
+    McpModel* mcp = NULL;
+    if(pin == &gpio_ext_pa4) mcp = &bus->mcp[0];
+    if(pin == &gpio_ext_pc3) mcp = &bus->mcp[1];
+    if(!mcp) return;
+
+    if(!state) {
+        bus->selected = mcp;
+        mcp->byte_index = 0;
+    } else if(bus->selected == mcp) {
+        bus->selected = NULL;
+        bus->frames++;
+    }
+}
+
+static void live_spi_tx(const uint8_t* data, size_t size, void* context) {
+    CartBus* bus = context;
+    McpModel* mcp = bus->selected;
+    bus->spi_bytes += size;
+    for(size_t i = 0; i < size; i++) {
+        bus->shift_register = (bus->shift_register << 8) | data[i];
+    }
+    if(!mcp) return;
+
+    for(size_t i = 0; i < size; i++, mcp->byte_index++) {
+        if(mcp->byte_index == 0) {
+            mcp->opcode = data[i];
+        } else if(mcp->byte_index == 1) {
+            mcp->pointer = data[i];
+        } else if(!(mcp->opcode & 1)) {
+            mcp_model_write(bus, mcp, data[i]);
+        }
+    }
+}
+
+static void live_spi_rx(uint8_t* data, size_t size, void* context) {
+    CartBus* bus = context;
+    McpModel* mcp = bus->selected;
+    bus->spi_bytes += size;
+    for(size_t i = 0; i < size; i++) {
+        data[i] = mcp ? mcp_model_read(bus, mcp) : 0xFF;
+    }
+}
+
+// ---- Decodificación de la traza ----
+
+static void stats_add_op(TraceStats* stats, OpType type, uint16_t address, uint8_t value) {
+    if(stats->op_count == stats->op_capacity) {
+        stats->op_capacity = stats->op_capacity ? stats->op_capacity * 2 : 1024;
+        stats->ops = realloc(stats->ops, stats->op_capacity * sizeof(LogicalOp));
+    }
+    stats->ops[stats->op_count++] = (LogicalOp){type, address, value};
+    if(type == OP_READ) {
+        stats->logical_reads++;
+    } else {
+        stats->logical_writes++;
+    }
+}
+
+static bool trace_decode(const char* path, TraceStats* stats) {
+    FILE* file = fopen(path, "rb");
+    if(!file) {
+        fprintf(stderr, "%s: no se pudo abrir\n", path);
+        return false;
+    }
+
+    MCP23S17TraceHeader header;
+    if(fread(&header, sizeof(header), 1, file) != 1 ||
+       memcmp(header.magic, MCP23S17_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+       header.frame_size != sizeof(MCP23S17TraceFrame)) {
+        fprintf(stderr, "%s: no es una traza MCP23S17 valida\n", path);
+        fclose(file);
+        return false;
+    }
+    stats->cycles_per_us = header.cycles_per_us ? header.cycles_per_us : 64;
+
+    CartBus bus;
+    cart_bus_reset_idle(&bus);
+
+    MCP23S17TraceFrame frame;
+    uint32_t last_timestamp = 0;
+    bool first = true;
+    while(fread(&frame, sizeof(frame), 1, file) == 1) {
+        if(!first) stats->duration_cycles += (uint32_t)(frame.timestamp - last_timestamp);
+        last_timestamp = frame.timestamp;
+        first = false;
+        if(frame.chip == MCP23S17_TRACE_CHIP_GPIO) {
+            // No son tramas SPI: sólo cambian el estado de RD/WR/CS
+            stats->gpio_frames++;
+            cart_bus_native(&bus, frame.reg, frame.length > 0 && frame.data[0]);
+            if(bus.write_seen) {
+                bus.write_seen = false;
+                stats_add_op(stats, OP_WRITE, bus.write_address, bus.write_value);
+            }
+            continue;
+        }
+
+        stats->frames++;
+        if(frame.chip == MCP23S17_TRACE_CHIP_SHIFT_595) {
+            // A8-A15 primero, A0-A7 después (ver gb_address.c)
+            stats->shift_frames++;
+            stats->spi_bytes += frame.length;
+            if(frame.length >= 2) {
+                bus.shift_mode = true;
+                bus.shift_address = (frame.data[0] << 8) | frame.data[1];
+            }
+            continue;
+        }
+
+        McpModel* mcp = NULL;
+        if(frame.chip == REPLAY_MCP1_ADDRESS) mcp = &bus.mcp[0];
+        if(frame.chip == REPLAY_MCP2_ADDRESS) mcp = &bus.mcp[1];
+        if(!mcp) continue;
+
+        stats->spi_bytes += 2 + frame.length;
+        mcp->pointer = frame.reg;
+        if(frame.opcode & 1) {
+            stats->reads_frames++;
+            // Lectura del bus de datos con RD activo = lectura lógica del cartucho
+            if(mcp == &bus.mcp[1] && frame.reg == MCP23S17_GPIOB && frame.length > 0 &&
+               cart_bus_rd_active(&bus)) {
+                stats_add_op(stats, OP_READ, cart_bus_address(&bus), frame.data[0]);
+            }
+        } else {
+            stats->writes_frames++;
+            for(uint8_t i = 0; i < frame.length; i++) {
+                mcp_model_write(&bus, mcp, frame.data[i]);
+                if(bus.write_seen) {
+                    bus.write_seen = false;
+                    stats_add_op(stats, OP_WRITE, bus.write_address, bus.write_value);
+                }
+            }
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+// ---- Ejecución con el código actual ----
+
+// Conecta mcp23s17_api/gb_cart al bus emulado y los inicializa
+// Dispositivos del lado del Flipper para la ejecución en vivo
+typedef struct {
+    MCP23S17 mcp1;
+    MCP23S17 mcp2;
+    Shift595 shift;
+    GBAddressBackend address;
+} ReplayDevices;
+
+static void replay_bus_setup(
+    CartBus* bus,
+    HostBus* host,
+    ReplayDevices* devices,
+    GBAddressType address_type,
+    GBCartWiring wiring) {
+    memset(bus, 0, sizeof(CartBus));
+    mcp_model_reset(&bus->mcp[0], REPLAY_MCP1_ADDRESS);
+    mcp_model_reset(&bus->mcp[1], REPLAY_MCP2_ADDRESS);
+    bus->last_wr = true;
+    bus->native_rd = true;
+    bus->native_wr = true;
+    bus->native_cs = true;
+    bus->shift_mode = address_type == GB_ADDRESS_SHIFT_595;
+
+    memset(host, 0, sizeof(HostBus));
+    host->gpio_write = live_gpio_write;
+    host->spi_tx = live_spi_tx;
+    host->spi_rx = live_spi_rx;
+    host->context = bus;
+    host_bus_set(host);
+
+    memset(devices, 0, sizeof(ReplayDevices));
+    FuriHalSpiBusHandle* spi = &furi_hal_spi_bus_handle_external;
+    if(address_type == GB_ADDRESS_SHIFT_595) {
+        shift_595_init(&devices->shift, spi, &gpio_ext_pa4, 2);
+        gb_address_setup_shift_595(&devices->address, &devices->shift);
+    } else {
+        mcp23s17_init(&devices->mcp1, REPLAY_MCP1_ADDRESS, spi, &gpio_ext_pa4);
+        gb_address_setup_mcp23s17(&devices->address, &devices->mcp1);
+    }
+    mcp23s17_init(&devices->mcp2, REPLAY_MCP2_ADDRESS, spi, &gpio_ext_pc3);
+    gb_cart_set_wiring(wiring);
+    gb_cart_init(&devices->address, &devices->mcp2);
+}
+
+static void trace_replay(TraceStats* stats) {
+    CartBus bus;
+    HostBus host;
+    ReplayDevices devices;
+    // Los pines nativos y las tramas de los 595 indican el hardware de la traza
+    GBCartWiring wiring = stats->gpio_frames ? GB_CART_WIRING_HYBRID : GB_CART_WIRING_MCP;
+    GBAddressType address_type = stats->shift_frames ? GB_ADDRESS_SHIFT_595 : GB_ADDRESS_MCP23S17;
+    replay_bus_setup(&bus, &host, &devices, address_type, wiring);
+
+    // Sólo cuentan las tramas de las operaciones, no las de inicialización
+    bus.frames = 0;
+    bus.spi_bytes = 0;
+
+    for(size_t i = 0; i < stats->op_count; i++) {
+        const LogicalOp* op = &stats->ops[i];
+        bus.read_seen = false;
+        bus.write_seen = false;
+
+        if(op->type == OP_READ) {
+            uint8_t value = 0;
+            bus.next_read_value = op->value;
+            gb_cart_read_byte(op->address, &value);
+            if(!bus.read_seen || bus.read_address != op->address || value != op->value) {
+                stats->replay_mismatches++;
+            }
+        } else {
+            gb_cart_write_byte(op->address, op->value);
+            if(!bus.write_seen || bus.write_address != op->address || bus.write_value != op->value) {
+                stats->replay_mismatches++;
+            }
+        }
+    }
+
+    stats->replay_frames = bus.frames;
+    stats->replay_spi_bytes = bus.spi_bytes;
+}
+
+static double stats_duration_us(const TraceStats* stats) {
+    return (double)stats->duration_cycles / stats->cycles_per_us;
+}
+
+static double per_op(double value, const TraceStats* stats) {
+    size_t ops = stats->op_count;
+    return ops ? value / ops : 0.0;
+}
+
+static void stats_print(const char* path, const TraceStats* stats) {
+    double duration = stats_duration_us(stats);
+    double us_per_frame = stats->frames ? duration / stats->frames : 0.0;
+
+    printf("== %s\n", path);
+    printf("Traza:\n");
+    printf("  tramas            %u (%u escritura, %u lectura)\n",
+           stats->frames, stats->writes_frames, stats->reads_frames);
+    printf("  bytes SPI         %u\n", stats->spi_bytes);
+    printf("  cableado          %s (%u cambios de pines nativos)\n",
+           stats->gpio_frames ? "hibrido" : "MCP", stats->gpio_frames);
+    printf("  direcciones       %s\n", stats->shift_frames ? "74HC595" : "MCP1");
+    printf("  duracion          %.3f ms\n", duration / 1000.0);
+    printf("  us por trama      %.2f\n", us_per_frame);
+    printf("  ops del cartucho  %u lecturas, %u escrituras\n",
+           stats->logical_reads, stats->logical_writes);
+    printf("  tramas por op     %.2f\n", per_op(stats->frames, stats));
+    printf("  us por op         %.2f\n", per_op(duration, stats));
+    printf("Codigo actual:\n");
+    printf("  tramas            %u\n", stats->replay_frames);
+    printf("  bytes SPI         %u\n", stats->replay_spi_bytes);
+    printf("  tramas por op     %.2f\n", per_op(stats->replay_frames, stats));
+    printf("  tiempo estimado   %.3f ms (a %.2f us por trama)\n",
+           stats->replay_frames * us_per_frame / 1000.0, us_per_frame);
+    printf("  ops incorrectas   %u\n", stats->replay_mismatches);
+}
+
+static void stats_compare(const TraceStats* a, const TraceStats* b) {
+    printf("== Diferencia (segunda - primera)\n");
+    printf("  tramas por op     %+.2f\n", per_op(b->frames, b) - per_op(a->frames, a));
+    printf("  us por op         %+.2f\n",
+           per_op(stats_duration_us(b), b) - per_op(stats_duration_us(a), a));
+    printf("  bytes SPI por op  %+.2f\n", per_op(b->spi_bytes, b) - per_op(a->spi_bytes, a));
+}
+
+static bool synth_write_callback(const uint8_t* data, size_t size, void* context) {
+    return fwrite(data, 1, size, (FILE*)context) == size;
+}
+
+// Genera una traza con el código actual sobre el bus emulado: cabecera,
+// cambio de banco y lectura de 256 bytes del banco 1. Sirve para comparar
+// cambios en mcp23s17_api/gb_cart sin tener el Flipper a mano.
+static bool trace_synth(const char* path, GBAddressType address_type, GBCartWiring wiring) {
+    FILE* file = fopen(path, "wb");
+    if(!file) {
+        fprintf(stderr, "%s: no se pudo crear\n", path);
+        return false;
+    }
+
+    CartBus bus;
+    HostBus host;
+    ReplayDevices devices;
+    replay_bus_setup(&bus, &host, &devices, address_type, wiring);
+
+    mcp23s17_trace_start(synth_write_callback, file);
+    uint8_t value;
+    for(uint16_t address = 0x0100; address < 0x0150; address++) {
+        bus.next_read_value = address & 0xFF;
+        gb_cart_read_byte(address, &value);
+    }
+    gb_cart_write_byte(0x2000, 0x01);
+    for(uint16_t address = 0x4000; address < 0x4100; address++) {
+        bus.next_read_value = (address >> 4) ^ address;
+        gb_cart_read_byte(address, &value);
+    }
+    mcp23s17_trace_stop();
+
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if(argc >= 3 && strcmp(argv[1], "--synth") == 0) {
+        GBCartWiring wiring = GB_CART_WIRING_MCP;
+        GBAddressType address_type = GB_ADDRESS_MCP23S17;
+        for(int i = 3; i < argc; i++) {
+            if(strcmp(argv[i], "--hybrid") == 0) {
+                wiring = GB_CART_WIRING_HYBRID;
+            } else if(strcmp(argv[i], "--595") == 0) {
+                address_type = GB_ADDRESS_SHIFT_595;
+            } else {
+                return 1;
+            }
+        }
+        return trace_synth(argv[2], address_type, wiring) ? 0 : 1;
+    }
+    if(argc < 2 || argc > 3) {
+        fprintf(stderr, "Uso: %s traza.bin [otra_traza.bin]\n", argv[0]);
+        fprintf(stderr, "     %s --synth salida.bin [--hybrid] [--595]\n", argv[0]);
+        return 1;
+    }
+
+    TraceStats stats[2];
+    memset(stats, 0, sizeof(stats));
+    int traces = argc - 1;
+    int exit_code = 0;
+
+    for(int i = 0; i < traces; i++) {
+        if(!trace_decode(argv[i + 1], &stats[i])) return 1;
+        trace_replay(&stats[i]);
+        stats_print(argv[i + 1], &stats[i]);
+        if(stats[i].replay_mismatches) exit_code = 2;
+    }
+    if(traces == 2) stats_compare(&stats[0], &stats[1]);
+
+    for(int i = 0; i < traces; i++) free(stats[i].ops);
+    return exit_code;
+}